@@ -60,6 +60,14 @@
 (define nboyer-iters      10000)
 (define sboyer-iters      10000)
 (define gcbench-iters       100)
+(define bigheap-iters       100)
+(define yield-iters         100)
+(define sleepers-iters      100)
+(define mailbox-iters       100)
+(define pfib-iters          500)
+(define c10k-iters          100)
+(define fileread-iters      1000)
+(define bulkcopy-iters      100)
 (define compiler-iters    30000)
 (define chud100K-iters      100)
 (define chud1K-iters     100000)
@@ -60,6 +60,14 @@
 (define nboyer-iters       10)
 (define sboyer-iters       10)
 (define gcbench-iters       1)
+(define bigheap-iters       1)
+(define yield-iters         1)
+(define sleepers-iters      1)
+(define mailbox-iters       1)
+(define pfib-iters          5)
+(define c10k-iters          1)
+(define fileread-iters      10)
+(define bulkcopy-iters      1)
 (define compiler-iters     30)
 (define chud100K-iters      1)
 (define chud1K-iters     1000)
@@ -60,6 +60,14 @@
 (define nboyer-iters      1)
 (define sboyer-iters      1)
 (define gcbench-iters     1)
+(define bigheap-iters     1)
+(define yield-iters       1)
+(define sleepers-iters    1)
+(define mailbox-iters     1)
+(define pfib-iters        1)
+(define c10k-iters        1)
+(define fileread-iters    1)
+(define bulkcopy-iters    1)
 (define compiler-iters    1)
 (define chud100K-iters    1)
 (define chud1K-iters      1)
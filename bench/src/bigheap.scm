@@ -0,0 +1,53 @@
+;;; BIGHEAP -- Stress the garbage collector with a large live heap.
+
+;;; A large number of long lived binary trees are kept in a vector so
+;;; that every garbage collection has many objects to mark and copy.
+;;; While short lived trees are allocated, some of the long lived trees
+;;; are replaced so that the live data doesn't stay the same.  This
+;;; measures the throughput of the parallel scan of the garbage
+;;; collector more than gcbench, whose live data is smaller.
+
+(define (make-tree depth)
+  (if (= depth 0)
+      (cons #f #f)
+      (cons (make-tree (- depth 1))
+            (make-tree (- depth 1)))))
+
+(define (check-tree tree)
+  (if (car tree)
+      (+ 1
+         (check-tree (car tree))
+         (check-tree (cdr tree)))
+      1))
+
+(define (bigheap nb-trees depth nb-steps)
+  (let ((live (make-vector nb-trees #f)))
+    (let loop ((i 0))
+      (if (< i nb-trees)
+          (begin
+            (vector-set! live i (make-tree depth))
+            (loop (+ i 1)))))
+    (let loop ((step 0) (seed 1))
+      (if (< step nb-steps)
+          (let ((seed (modulo (+ (* seed 1103515245) 12345) 2147483648)))
+            (check-tree (make-tree (- depth 2)))
+            (vector-set! live
+                         (modulo seed nb-trees)
+                         (make-tree depth))
+            (loop (+ step 1) seed))
+          (let sum ((i 0) (total 0))
+            (if (< i nb-trees)
+                (sum (+ i 1) (+ total (check-tree (vector-ref live i))))
+                total))))))
+
+(define (main . args)
+  (run-benchmark
+   "bigheap"
+   bigheap-iters
+   (lambda (result) (equal? result (* 256 (- (expt 2 14) 1))))
+   (lambda (nb-trees depth nb-steps)
+     (lambda ()
+       (bigheap nb-trees depth nb-steps)))
+   256
+   13
+   2000))
@@ -0,0 +1,119 @@
+;;; BULKCOPY -- Copy bytes from file to file and from socket to socket.
+
+;;; The ports are opened with the buffer-size: setting below, so the
+;;; time depends on the length of the byte buffers of the ports and on
+;;; the number of system calls needed to transfer the data.  Changing
+;;; the setting to a fixnum, such as 1024, compares fixed length
+;;; buffers to buffers that grow adaptively.
+
+(define buffer-size 'adaptive)
+
+(define file-length 4000000)
+
+(define chunk-length 65536)
+
+(define (make-file path)
+  (call-with-output-file path
+    (lambda (port)
+      (let loop ((i 0))
+        (if (< i file-length)
+            (begin
+              (write-u8 (modulo i 251) port)
+              (loop (+ i 1))))))))
+
+(define (copy in out)
+  (let ((chunk (make-u8vector chunk-length)))
+    (let loop ()
+      (let ((n (read-subu8vector chunk 0 chunk-length in)))
+        (if (> n 0)
+            (begin
+              (write-subu8vector chunk 0 n out)
+              (loop))
+            (force-output out))))))
+
+(define (checksum in)
+  (let ((chunk (make-u8vector chunk-length)))
+    (let loop ((sum 0))
+      (let ((n (read-subu8vector chunk 0 chunk-length in)))
+        (if (> n 0)
+            (let sum-chunk ((i 0) (sum sum))
+              (if (< i n)
+                  (sum-chunk (+ i 1) (+ sum (u8vector-ref chunk i)))
+                  (loop sum)))
+            sum)))))
+
+(define (file->file src dst)
+  (let ((in (open-input-file (list path: src buffer-size: buffer-size)))
+        (out (open-output-file (list path: dst buffer-size: buffer-size))))
+    (copy in out)
+    (close-port in)
+    (close-port out)
+    (call-with-input-file dst checksum)))
+
+;; The file is sent on a first connection to the server, which copies
+;; what it receives to a second connection where the bytes are summed.
+
+(define (socket->socket src)
+  (let* ((server
+          (open-tcp-server
+           (list local-address: "127.0.0.1"
+                 port-number: 0
+                 buffer-size: buffer-size)))
+         (port-number
+          (socket-info-port-number (tcp-server-socket-info server)))
+         (connect
+          (lambda ()
+            (open-tcp-client
+             (list address: "127.0.0.1"
+                   port-number: port-number
+                   buffer-size: buffer-size))))
+         (sender
+          (connect))
+         (receiver
+          (connect))
+         (from
+          (read server))
+         (to
+          (read server))
+         (forwarder
+          (thread-start!
+           (make-thread
+            (lambda ()
+              (copy from to)
+              (close-port to)))))
+         (writer
+          (thread-start!
+           (make-thread
+            (lambda ()
+              (let ((in (open-input-file
+                         (list path: src buffer-size: buffer-size))))
+                (copy in sender)
+                (close-port in)
+                (close-output-port sender))))))
+         (result
+          (checksum receiver)))
+    (thread-join! writer)
+    (thread-join! forwarder)
+    (close-port sender)
+    (close-port receiver)
+    (close-port from)
+    (close-port server)
+    result))
+
+(define (bulkcopy src dst)
+  (+ (file->file src dst)
+     (socket->socket src)))
+
+(define (main . args)
+  (let ((src "bulkcopy-src.tmp")
+        (dst "bulkcopy-dst.tmp"))
+    (make-file src)
+    (run-benchmark
+     "bulkcopy"
+     bulkcopy-iters
+     (lambda (result) (equal? result 999988032))
+     (lambda (src dst) (lambda () (bulkcopy src dst)))
+     src
+     dst)
+    (delete-file src)
+    (delete-file dst)))
@@ -0,0 +1,83 @@
+;;; C10K -- Many mostly idle TCP connections on the loopback interface.
+
+;;; A server echoes the bytes it receives on each connection.  Most of
+;;; the connections stay idle while a few clients exchange bytes with
+;;; the server, so the cost of waiting for IO depends on how well the
+;;; runtime handles a large number of waiting devices.
+
+(define (echo conn)
+  (let loop ()
+    (let ((b (read-u8 conn)))
+      (if (eof-object? b)
+          (close-port conn)
+          (begin
+            (write-u8 b conn)
+            (force-output conn)
+            (loop))))))
+
+(define (accept server n)
+  (let loop ((i 0))
+    (if (< i n)
+        (let ((conn (read server)))
+          (thread-start! (make-thread (lambda () (echo conn))))
+          (loop (+ i 1))))))
+
+(define (connect port-number)
+  (open-tcp-client (list address: "127.0.0.1" port-number: port-number)))
+
+(define (ping-pong conn rounds)
+  (let loop ((i 0))
+    (if (< i rounds)
+        (begin
+          (write-u8 (modulo i 256) conn)
+          (force-output conn)
+          (if (eqv? (read-u8 conn) (modulo i 256))
+              (+ 1 (loop (+ i 1)))
+              0))
+        0)))
+
+(define (c10k nb-idle nb-active rounds)
+  (let* ((server
+          (open-tcp-server
+           (list local-address: "127.0.0.1" port-number: 0 backlog: 1024)))
+         (port-number
+          (socket-info-port-number (tcp-server-socket-info server)))
+         (acceptor
+          (thread-start!
+           (make-thread
+            (lambda () (accept server (+ nb-idle nb-active))))))
+         (idle
+          (let loop ((i 0) (conns '()))
+            (if (< i nb-idle)
+                (loop (+ i 1) (cons (connect port-number) conns))
+                conns)))
+         (active
+          (let loop ((i 0) (threads '()))
+            (if (< i nb-active)
+                (loop (+ i 1)
+                      (cons (thread-start!
+                             (make-thread
+                              (lambda ()
+                                (let* ((conn (connect port-number))
+                                       (n (ping-pong conn rounds)))
+                                  (close-port conn)
+                                  n))))
+                            threads))
+                threads)))
+         (result
+          (apply + (map thread-join! active))))
+    (for-each close-port idle)
+    (thread-join! acceptor)
+    (close-port server)
+    result))
+
+(define (main . args)
+  (run-benchmark
+   "c10k"
+   c10k-iters
+   (lambda (result) (equal? result 10000))
+   (lambda (nb-idle nb-active rounds)
+     (lambda () (c10k nb-idle nb-active rounds)))
+   400
+   10
+   1000))
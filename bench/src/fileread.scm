@@ -0,0 +1,37 @@
+;;; FILEREAD -- Read a file one byte at a time.
+
+;;; The file is read through the runtime's file device, so the time
+;;; depends on how the device reads the file.  Running the benchmark
+;;; with and without the -:io-uring runtime option compares reading
+;;; with io_uring to reading with read.
+
+(define file-length 1000000)
+
+(define (make-file path)
+  (call-with-output-file path
+    (lambda (port)
+      (let loop ((i 0))
+        (if (< i file-length)
+            (begin
+              (write-u8 (modulo i 251) port)
+              (loop (+ i 1))))))))
+
+(define (fileread path)
+  (call-with-input-file path
+    (lambda (port)
+      (let loop ((sum 0))
+        (let ((b (read-u8 port)))
+          (if (eof-object? b)
+              sum
+              (loop (+ sum b))))))))
+
+(define (main . args)
+  (let ((path "fileread.tmp"))
+    (make-file path)
+    (run-benchmark
+     "fileread"
+     fileread-iters
+     (lambda (result) (equal? result 124998120))
+     (lambda (path) (lambda () (fileread path)))
+     path)
+    (delete-file path)))
@@ -0,0 +1,77 @@
+;;; MAILBOX -- Message passing between threads with thread-send.
+
+;;; In the ping-pong part two threads send a counter back and forth.
+;;; In the fan-in part many producer threads send messages to a single
+;;; consumer, which removes all the pending messages of its mailbox at
+;;; once with thread-receive-all.  When more than one processor is
+;;; used, the threads run on different processors so the messages
+;;; cross processors.
+
+(define (ping-pong n)
+  (let* ((ponger
+          (make-thread
+           (lambda ()
+             (let loop ()
+               (let ((msg (thread-receive)))
+                 (if (pair? msg)
+                     (begin
+                       (thread-send (car msg) (+ (cdr msg) 1))
+                       (loop))))))))
+         (self
+          (current-thread)))
+    (thread-start! ponger)
+    (let loop ((i 0))
+      (if (< i n)
+          (begin
+            (thread-send ponger (cons self i))
+            (loop (thread-receive)))
+          (begin
+            (thread-send ponger 'stop)
+            (thread-join! ponger)
+            i)))))
+
+(define (fan-in nb-producers n)
+  (let* ((consumer
+          (make-thread
+           (lambda ()
+             (let loop ((remaining (* nb-producers n)) (sum 0))
+               (if (> remaining 0)
+                   (let ((msgs (thread-receive-all)))
+                     (if (null? msgs)
+                         (let ((msg (thread-receive)))
+                           (loop (- remaining 1) (+ sum msg)))
+                         (let add ((msgs msgs) (remaining remaining) (sum sum))
+                           (if (pair? msgs)
+                               (add (cdr msgs) (- remaining 1) (+ sum (car msgs)))
+                               (loop remaining sum)))))
+                   sum)))))
+         (producers
+          (let loop ((i 0) (producers '()))
+            (if (< i nb-producers)
+                (loop (+ i 1)
+                      (cons (make-thread
+                             (lambda ()
+                               (let loop ((j 0))
+                                 (if (< j n)
+                                     (begin
+                                       (thread-send consumer 1)
+                                       (loop (+ j 1)))))))
+                            producers))
+                producers))))
+    (thread-start! consumer)
+    (for-each thread-start! producers)
+    (for-each thread-join! producers)
+    (thread-join! consumer)))
+
+(define (mailbox n nb-producers)
+  (+ (ping-pong n)
+     (fan-in nb-producers n)))
+
+(define (main . args)
+  (run-benchmark
+   "mailbox"
+   mailbox-iters
+   (lambda (result) (equal? result 1700000))
+   (lambda (n nb-producers) (lambda () (mailbox n nb-producers)))
+   100000
+   16))
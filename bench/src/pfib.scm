@@ -0,0 +1,27 @@
+;;; PFIB -- Parallel version of FIB using futures.
+
+;;; Below the cutoff the computation is sequential.  Above it one of
+;;; the two recursive calls is a future, so idle processors can steal
+;;; it, and the toucher evaluates it itself when it was not stolen.
+
+(define (fib n)
+  (if (< n 2)
+    n
+    (+ (fib (- n 1))
+       (fib (- n 2)))))
+
+(define (pfib n cutoff)
+  (if (< n cutoff)
+    (fib n)
+    (let ((f (future (pfib (- n 2) cutoff))))
+      (let ((x (pfib (- n 1) cutoff)))
+        (+ x (touch f))))))
+
+(define (main . args)
+  (run-benchmark
+    "pfib"
+    pfib-iters
+    (lambda (result) (equal? result 9227465))
+    (lambda (n cutoff) (lambda () (pfib n cutoff)))
+    35
+    20))
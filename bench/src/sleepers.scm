@@ -0,0 +1,37 @@
+;;; SLEEPERS -- Many threads sleeping with random timeouts.
+
+;;; A million threads each sleep for a random duration of less than a
+;;; second, so the timeout queues of the processors hold a very large
+;;; number of threads that are inserted in no particular order and
+;;; removed as their timeouts expire.  The durations come from a
+;;; linear congruential generator so that every run is the same.
+
+(define (random-timeout seed)
+  (modulo (+ (* seed 1103515245) 12345) 2147483648))
+
+(define (sleeper timeout)
+  (thread-sleep! timeout)
+  1)
+
+(define (sleepers nb-threads)
+  (let ((threads (make-vector nb-threads #f)))
+    (let loop ((i 0) (seed 1))
+      (if (< i nb-threads)
+          (let ((timeout (/ (exact->inexact seed) 2147483648.)))
+            (vector-set! threads
+                         i
+                         (thread-start!
+                          (make-thread (lambda () (sleeper timeout)))))
+            (loop (+ i 1) (random-timeout seed)))))
+    (let loop ((i 0) (count 0))
+      (if (< i nb-threads)
+          (loop (+ i 1) (+ count (thread-join! (vector-ref threads i))))
+          count))))
+
+(define (main . args)
+  (run-benchmark
+   "sleepers"
+   sleepers-iters
+   (lambda (result) (equal? result 1000000))
+   (lambda (nb-threads) (lambda () (sleepers nb-threads)))
+   1000000))
@@ -0,0 +1,35 @@
+;;; YIELD -- Context switches between many threads of equal priority.
+
+;;; Each thread counts its iterations and yields to the next runnable
+;;; thread, so the scheduler's run queue is constantly removing a
+;;; thread at its head and adding one at its tail.  The counts are
+;;; summed after the threads are joined, so the result doesn't depend
+;;; on the number of processors running the threads.
+
+(define (yielder n)
+  (let loop ((i 0))
+    (if (< i n)
+        (begin
+          (thread-yield!)
+          (loop (+ i 1)))
+        i)))
+
+(define (yield nb-threads n)
+  (let loop ((i 0) (threads '()))
+    (if (< i nb-threads)
+        (loop (+ i 1)
+              (cons (thread-start! (make-thread (lambda () (yielder n))))
+                    threads))
+        (let sum ((threads threads) (count 0))
+          (if (pair? threads)
+              (sum (cdr threads) (+ count (thread-join! (car threads))))
+              count)))))
+
+(define (main . args)
+  (run-benchmark
+   "yield"
+   yield-iters
+   (lambda (result) (equal? result 1000000))
+   (lambda (nb-threads n) (lambda () (yield nb-threads n)))
+   1000
+   1000))
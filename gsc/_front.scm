@@ -1883,9 +1883,6 @@
         ((app? node)
          (gen-call node live reason))
 
-        ((fut? node)
-         (gen-fut node live reason))
-
         (else
          (compiler-internal-error
            "gen-node, unknown parse tree node type:" node))))
@@ -4218,146 +4215,3 @@
                     (cdr vals))))
 
 ;;;----------------------------------------------------------------------------
-;;
-;; generate code for a future
-
-(define (gen-fut node live reason)
-  (let* ((val (fut-val node))
-         (clo-vars (not-constant-closed-vars val))
-         (clo-vars-list (varset->list clo-vars))
-         (ret-var* (make-temp-var 0))
-         (live-after live)
-         (live-starting-task (varset-adjoin (varset-union live-after clo-vars)
-                                            ret-var*))
-         (task-lbl (bbs-new-lbl! *bbs*))
-         (return-lbl (bbs-new-lbl! *bbs*)))
-
-    ; save regs on stack if they contain values needed after the future
-    (save-regs-to-stk (live-regs live-after)
-                      live-starting-task
-                      (node->comment node))
-
-    (let* ((top-live-slot
-            (stk-num (highest-live-slot live-after)))
-           (frame-start
-            (let ((frame-reserve
-                   (frame-constraints-reserve target.frame-constraints))
-                  (frame-align
-                   (frame-constraints-align target.frame-constraints)))
-              (* (+ (quotient (+ (+ top-live-slot frame-reserve)
-                                 (- frame-align 1))
-                              frame-align)
-                    1) ;; reserve space for a break frame
-                 frame-align))))
-
-      ; move return address to where task expects it
-      (save-opnd-to-reg (make-lbl return-lbl)
-                        return-addr-reg
-                        ret-var*
-                        (varset-remove live-starting-task ret-var*)
-                        (node->comment node))
-
-      ; save variables that the task needs (that are not in regs)
-      (let loop1 ((l clo-vars-list) (i 0))
-        (if (null? l)
-          (adjust-slots
-           (+ frame-start i)
-           live-starting-task
-           (node->comment node))
-          (let ((var (car l))
-                (rest (cdr l)))
-            (if (memq var regs)
-              (loop1 rest i)
-              (let ((live-v
-                     (varset-union live-starting-task
-                                   (live-vars (list->varset rest)))))
-                (let loop2 ((j (- target.nb-regs 1)))
-                  (if (>= j 0)
-                    (if (or (>= j (length regs))
-                            (not (varset-member? (list-ref regs j)
-                                                 live-v)))
-                      (let ((reg (make-reg j)))
-                        (put-copy (var->opnd var)
-                                  reg
-                                  var
-                                  live-v
-                                  (node->comment node))
-                        (loop1 rest i))
-                      (loop2 (- j 1)))
-                  (let ((slot (make-stk (+ frame-start (+ i 1))))
-                        (needed (list->varset rest)))
-                      (if (and (or (> (stk-num slot) nb-slots)
-                                 (not (memq (list-ref slots (- nb-slots (stk-num slot))) regs)))
-                             (memq (stk-num slot) (live-slots needed)))
-                      (save-opnd slot
-                                 live-v
-                                 (node->comment node)))
-                    (put-copy (var->opnd var)
-                              slot
-                              var
-                              live-v
-                              (node->comment node))
-                    (loop1 rest (+ i 1))))))))))
-
-      (let ((frame-reserve
-             (frame-constraints-reserve
-              target.frame-constraints)))
-        (let loop3 ((i (- frame-reserve 1)))
-          (if (>= i 0)
-            (begin
-              (put-var (make-stk (- frame-start i))
-                       empty-var)
-              (loop3 (- i 1))))))
-
-      (seal-bb node 'call)
-
-      (emit-instr!
-       (make-jump (make-lbl task-lbl)
-                  #f
-                  #f
-                  #f
-                  #f
-                  (current-frame live-starting-task)
-                  (node->comment node)))
-
-      (let ((task-context
-              (make-context (- nb-slots frame-start)
-                            (reverse (drop (reverse slots) frame-start))
-                            (cons ret-var (cdr regs))
-                            '()
-                            poll
-                            entry-bb))
-            (return-context
-              (make-context frame-start
-                            (drop slots (- nb-slots frame-start))
-                            '()
-                            closed
-                            (return-poll poll 'internal)
-                            entry-bb)))
-
-        (restore-context task-context)
-        (set! *bb* (make-bb
-                    (emit-label!
-                     (make-label-task-entry
-                      task-lbl
-                      (current-frame live-starting-task)
-                      (node->comment node)))
-                    *bbs*))
-
-        (gen-node val ret-var-set (make-reason-tail))
-
-        (let ((result-var (make-temp-var 'future)))
-          (restore-context return-context)
-          (put-var target.proc-result result-var)
-
-          (set! *bb* (make-bb
-                      (emit-label!
-                       (make-label-task-return
-                        return-lbl
-                        (current-frame (varset-adjoin live result-var))
-                        (node->comment node)))
-                      *bbs*))
-
-          (gen-return node live reason target.proc-result))))))
-
-;;;----------------------------------------------------------------------------
@@ -94,6 +94,7 @@
 (define **unbox-sym            (string->canonical-symbol "##unbox"))
 (define **set-box!-sym         (string->canonical-symbol "##set-box!"))
 (define **make-delay-promise-sym (string->canonical-symbol "##make-delay-promise"))
+(define **make-future-sym     (string->canonical-symbol "##make-future"))
 (define **with-exception-catcher-sym (string->canonical-symbol "##with-exception-catcher"))
 (define **raise-sym            (string->canonical-symbol "##raise"))
 (define **r7rs-with-exception-catcher-sym (string->canonical-symbol "##r7rs-with-exception-catcher"))
@@ -195,16 +195,6 @@
            (eq? (app-oper parent) node))
       #f)))
 
-(define (new-fut source env val)
-  (let ((node (make-fut #f (list val) #t #t env source)))
-    (node-parent-set! val node)
-    node))
-
-(define (fut-val x)
-  (if (fut? x)
-    (car (node-children x))
-    (compiler-internal-error "fut-val, 'fut' node expected" x)))
-
 (define (new-disj-call source env pre oper alt)
   (new-call* source env
     (let* ((temp (new-temp-variable source 'cond-temp))
@@ -2121,8 +2111,10 @@
 
 (define (pt-future source env use)
   (let ((code (source-code source)))
-    (new-fut source env
-      (pt (cadr code) env 'true))))
+    (new-call* source (add-not-safe env)
+      (new-ref-extended-bindings source **make-future-sym env)
+      (list (new-prc source env #f #f '() '() #f #f
+              (pt (cadr code) env 'true))))))
 
 ;; Expression identification predicates and syntax checking.
 
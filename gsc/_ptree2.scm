@@ -142,10 +142,6 @@
                (cp (app-oper ptree) substs)
                (map (lambda (x) (cp x substs)) (app-args ptree))))))
 
-        ((fut? ptree)
-         (new-fut (node-source ptree) (node-env ptree)
-           (cp (fut-val ptree) substs)))
-
         (else
          (compiler-internal-error "cp, unknown parse tree node type"))))
 
@@ -553,10 +549,6 @@
                (ac oper mut)
                (map (lambda (x) (ac x mut)) args)))))
 
-        ((fut? ptree)
-         (new-fut (node-source ptree) (node-env ptree)
-           (ac (fut-val ptree) mut)))
-
         (else
          (compiler-internal-error "ac, unknown parse tree node type"))))
 
@@ -1096,10 +1088,6 @@
                    (br-app-simplify ptree br-oper args substs reason expansion-limit)))
              (br-app ptree oper args substs reason expansion-limit))))
 
-        ((fut? ptree)
-         (new-fut (node-source ptree) (node-env ptree)
-           (br (fut-val ptree) substs 'need expansion-limit)))
-
         (else
          (compiler-internal-error "br, unknown parse tree node type"))))
 
@@ -1504,9 +1492,6 @@
                     (and proc
                          (not (proc-obj-side-effects? proc))))))))
 
-        ((fut? ptree)
-         (side-effects-impossible? (fut-val ptree)))
-
         (else
          (compiler-internal-error "side-effects-impossible?, unknown parse tree node type"))))
 
@@ -1547,8 +1532,7 @@
              (def? ptree) ; guaranteed to be a toplevel definition
              (tst? ptree)
              (conj? ptree)
-             (disj? ptree)
-             (fut? ptree))
+             (disj? ptree))
          (for-each (lambda (child) (ll! child cst-procs env))
                    (node-children ptree)))
 
@@ -1917,12 +1901,6 @@
                      (cons (if (safe? (node-env ptree)) 'SAFE 'NOT-SAFE) call)
                      call)))))
 
-        ((fut? ptree)
-         (se-gen
-          (list future-sym (se (fut-val ptree) env num ctx))
-          ptree
-          ctx))
-
         (else
          (compiler-internal-error "se, unknown parse tree node type"))))
 
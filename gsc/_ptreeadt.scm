@@ -163,17 +163,6 @@
 
 (define (app? x) (eq? (vector-ref x 0) app-tag))
 
-(define (make-fut ;; node that represents future constructs
-         parent children fv bfv env source ;; common to all nodes
-
-    )
-
-  (vector fut-tag parent children fv bfv env source (next-node-stamp)))
-
-(define fut-tag (list 'fut-tag))
-
-(define (fut? x) (eq? (vector-ref x 0) fut-tag))
-
 (define (ptree? obj)
   (and (vector? obj)
        (> (vector-length obj) 0)
@@ -185,5 +174,4 @@
            (c#conj? obj)
            (c#disj? obj)
            (c#prc? obj)
-           (c#app? obj)
-           (c#fut? obj))))
+           (c#app? obj))))
@@ -1475,13 +1475,17 @@
                       (^obj #f)  ;; last-processor
                       ;;(^obj #f) ;; pinned
                       )))
-              (^obj #f) ;; unused-field15
+              (^obj #f) ;; toq-rightmost
               (^obj #f) ;; floats
               (^obj #f) ;; processor-deq-next
               (^obj #f) ;; processor-deq-prev
               (^obj #f) ;; id
               (^obj #f) ;; interrupts-head
               (^obj #f) ;; interrupts-tail
+              (^obj #f) ;; rq-rightmost
+              (^obj #f) ;; steal-seed
+              (^obj #f) ;; steal-attempts
+              (^obj #f) ;; threads-stolen
               ))))))
 
   ;;---------------------------------------------------------------------------
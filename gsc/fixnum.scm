@@ -278,6 +278,7 @@ string->canonical-symbol
 **letrec-sym
 **macro-scope-sym
 **make-delay-promise-sym
+**make-future-sym
 **namespace-scope-sym
 **namespace-sym
 **not-sym
@@ -492,9 +493,6 @@ disj-tag
 disj?
 environment-map?
 free-variables
-fut-tag
-fut-val
-fut?
 generative-lambda?
 global-proc-obj
 global-single-def
@@ -511,7 +509,6 @@ make-conj
 make-cst
 make-def
 make-disj
-make-fut
 make-prc
 make-ref
 make-set
@@ -524,7 +521,6 @@ new-conj
 new-cst
 new-def
 new-disj
-new-fut
 new-let
 new-prc
 new-ref
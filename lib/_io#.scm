@@ -46,6 +46,12 @@
 (##define-macro (macro-string-or-ip-address? obj)
   `(##string-or-ip-address? ,obj))
 
+(define-check-type mmap-window 'mmap-window
+  macro-mmap-window?)
+
+(##define-macro (macro-mmap-window? obj)
+  `(##mmap-window? ,obj))
+
 ;;;----------------------------------------------------------------------------
 
 ;;; Representation of ports.
@@ -858,6 +864,8 @@
   ignore-hidden
   tls-context
   capacity
+  buffer-size
+  mmap
 )
 
 (define-type psettings-options
@@ -1002,6 +1010,15 @@
 
 (##define-macro (macro-default-capacity) 0) ;; 0 = unlimited capacity
 
+(##define-macro (macro-default-buffer-size) 0) ;; 0 = default size
+(##define-macro (macro-adaptive-buffer-size) -1)
+(##define-macro (macro-min-buffer-size) 64) ;; enough for any char encoding
+(##define-macro (macro-max-buffer-size) 16777216)
+
+(##define-macro (macro-no-mmap)      0)
+(##define-macro (macro-mmap)         1)
+(##define-macro (macro-default-mmap) `(macro-no-mmap))
+
 (##define-macro (macro-stdin-from-port) 1)
 (##define-macro (macro-stdin-unchanged) 0)
 (##define-macro (macro-default-stdin-redir) `(macro-stdin-from-port))
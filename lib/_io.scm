@@ -229,7 +229,9 @@
           (macro-default-broadcast)
           (macro-default-ignore-hidden)
           (macro-default-tls-context)
-          (macro-default-capacity))))
+          (macro-default-capacity)
+          (macro-default-buffer-size)
+          (macro-default-mmap))))
     (##parse-psettings!
      allowed-settings
      settings
@@ -349,6 +351,24 @@
           (else
            #f)))
 
+  (define (buffer-size value)
+    (cond ((##eq? value 'adaptive)
+           (macro-adaptive-buffer-size))
+          ((and (##fixnum? value)
+                (##fx<= (macro-min-buffer-size) value)
+                (##fx<= value (macro-max-buffer-size)))
+           value)
+          (else
+           #f)))
+
+  (define (mmap value)
+    (cond ((##eq? value #t)
+           (macro-mmap))
+          ((##eq? value #f)
+           (macro-no-mmap))
+          (else
+           #f)))
+
   (define (permanent-close value)
     (cond ((##eq? value #t)
            (macro-permanent-close))
@@ -769,6 +789,26 @@
                                         (loop rest2))
                                       (error name))))
 
+                               ((##eq? name 'buffer-size:)
+                                (let ((x (buffer-size value)))
+                                  (if x
+                                      (begin
+                                        (macro-psettings-buffer-size-set!
+                                         psettings
+                                         x)
+                                        (loop rest2))
+                                      (error name))))
+
+                               ((##eq? name 'mmap:)
+                                (let ((x (mmap value)))
+                                  (if x
+                                      (begin
+                                        (macro-psettings-mmap-set!
+                                         psettings
+                                         x)
+                                        (loop rest2))
+                                      (error name))))
+
                                ((##eq? name 'permanent-close:)
                                 (let ((x (permanent-close value)))
                                   (if x
@@ -1249,6 +1289,7 @@
 (define-fail-check-type byte-output-port 'byte-output-port)
 (define-fail-check-type device-input-port 'device-input-port)
 (define-fail-check-type device-output-port 'device-output-port)
+(define-fail-check-type mmap-window 'mmap-window)
 
 ;;;----------------------------------------------------------------------------
 
@@ -1375,9 +1416,134 @@
 
 ;;; Implementation of device ports.
 
+;; When the buffer-size: setting is adaptive, the buffers of a
+;; buffered device port start at the default length and are doubled,
+;; up to a maximum length, when the buffer was full on
+;; ##adaptive-buffer-growth-count consecutive fills or drains.  This
+;; keeps the footprint of interactive ports small while reducing the
+;; number of system calls of bulk transfers.  The counters of
+;; consecutive full buffers are kept in the closures installed as the
+;; fill and drain procedures of the port.
+
+(define ##adaptive-buffer-growth-count 2)
+(define ##adaptive-byte-buf-max-len 262144)
+(define ##adaptive-char-buf-max-len 65536)
+
+(define-prim (##adaptive-buf-len len max-len)
+  (##fxmin max-len (##fx* 2 len)))
+
+(define-prim (##make-adaptive-byte-rbuf-fill)
+  (let ((full 0))
+    (lambda (port want block?)
+      (let ((result (##byte-rbuf-fill port want block?)))
+        (if (##eq? result #t)
+            (let* ((byte-rbuf (macro-byte-port-rbuf port))
+                   (len (##u8vector-length byte-rbuf)))
+              (if (##fx= (macro-byte-port-rhi port) len)
+                  (begin
+                    (set! full (##fx+ full 1))
+                    (if (and (##fx<= ##adaptive-buffer-growth-count full)
+                             (##fx< len ##adaptive-byte-buf-max-len)
+                             (##not (macro-unbuffered?
+                                     (macro-port-roptions port))))
+                        (let ((new-byte-rbuf
+                               (##make-u8vector
+                                (##adaptive-buf-len
+                                 len
+                                 ##adaptive-byte-buf-max-len))))
+                          (##subu8vector-move! byte-rbuf 0 len new-byte-rbuf 0)
+                          (macro-byte-port-rbuf-set! port new-byte-rbuf)
+                          (set! full 0))))
+                  (set! full 0))))
+        result))))
+
+(define-prim (##make-adaptive-byte-wbuf-drain)
+  (let ((full 0))
+    (lambda (port)
+      (let* ((len (##u8vector-length (macro-byte-port-wbuf port)))
+             (full? (##fx= (macro-byte-port-whi port) len))
+             (result (##byte-wbuf-drain port)))
+        (if (##not result) ;; the byte buffer is now empty?
+            (if full?
+                (begin
+                  (set! full (##fx+ full 1))
+                  (if (and (##fx<= ##adaptive-buffer-growth-count full)
+                           (##fx< len ##adaptive-byte-buf-max-len)
+                           (##not (macro-unbuffered?
+                                   (macro-port-woptions port))))
+                      (begin
+                        (macro-byte-port-wbuf-set!
+                         port
+                         (##make-u8vector
+                          (##adaptive-buf-len
+                           len
+                           ##adaptive-byte-buf-max-len)))
+                        (set! full 0))))
+                (set! full 0)))
+        result))))
+
+(define-prim (##make-adaptive-char-rbuf-fill)
+  (let ((full 0))
+    (lambda (port want block?)
+      (let ((result (##char-rbuf-fill port want block?)))
+        (if (##eq? result #t)
+            (let* ((char-rbuf (macro-character-port-rbuf port))
+                   (len (##string-length char-rbuf)))
+              (if (##fx= (macro-character-port-rhi port) len)
+                  (begin
+                    (set! full (##fx+ full 1))
+                    (if (and (##fx<= ##adaptive-buffer-growth-count full)
+                             (##fx< len ##adaptive-char-buf-max-len)
+                             (##not (macro-unbuffered?
+                                     (macro-port-roptions port))))
+                        (let ((new-char-rbuf
+                               (##make-string
+                                (##adaptive-buf-len
+                                 len
+                                 ##adaptive-char-buf-max-len))))
+                          (##substring-move! char-rbuf 0 len new-char-rbuf 0)
+                          (macro-character-port-rbuf-set! port new-char-rbuf)
+                          (set! full 0))))
+                  (set! full 0))))
+        result))))
+
+(define-prim (##make-adaptive-char-wbuf-drain)
+  (let ((full 0))
+    (lambda (port)
+      (let* ((len (##string-length (macro-character-port-wbuf port)))
+             (full? (##fx= (macro-character-port-whi port) len))
+             (result (##char-wbuf-drain port)))
+        (if (##not result) ;; the char buffer is now empty?
+            (if full?
+                (begin
+                  (set! full (##fx+ full 1))
+                  (if (and (##fx<= ##adaptive-buffer-growth-count full)
+                           (##fx< len ##adaptive-char-buf-max-len)
+                           (##not (macro-unbuffered?
+                                   (macro-port-woptions port))))
+                      (begin
+                        (macro-character-port-wbuf-set!
+                         port
+                         (##make-string
+                          (##adaptive-buf-len
+                           len
+                           ##adaptive-char-buf-max-len)))
+                        (set! full 0))))
+                (set! full 0)))
+        result))))
+
 (define-prim (##make-device-port device-name rdevice wdevice psettings)
 
-  (define byte-buf-len 1024) ;; byte buffer length
+  (define default-byte-buf-len 1024) ;; default byte buffer length
+
+  (define buffer-size (macro-psettings-buffer-size psettings))
+
+  (define byte-buf-len ;; byte buffer length
+    (if (##fx< 0 buffer-size)
+        buffer-size
+        default-byte-buf-len))
+
+  (define adaptive? (##fx= buffer-size (macro-adaptive-buffer-size)))
 
   (let* ((mutex
           (macro-make-port-mutex))
@@ -1424,7 +1590,9 @@
          (char-rcurline
           0)
          (char-rbuf-fill
-          ##char-rbuf-fill)
+          (if adaptive?
+              (##make-adaptive-char-rbuf-fill)
+              ##char-rbuf-fill))
          (char-peek-eof?
           #f)
          (char-wbuf
@@ -1442,7 +1610,9 @@
          (char-wcurline
           0)
          (char-wbuf-drain
-          ##char-wbuf-drain)
+          (if adaptive?
+              (##make-adaptive-char-wbuf-drain)
+              ##char-wbuf-drain))
          (input-readtable
           (##psettings->input-readtable psettings))
          (output-readtable
@@ -1455,7 +1625,9 @@
          (byte-rhi
           0)
          (byte-rbuf-fill
-          ##byte-rbuf-fill)
+          (if adaptive?
+              (##make-adaptive-byte-rbuf-fill)
+              ##byte-rbuf-fill))
          (byte-wbuf
           (and (##not (##fx= wkind (macro-none-kind)))
                (##make-u8vector byte-buf-len)))
@@ -1464,7 +1636,9 @@
          (byte-whi
           0)
          (byte-wbuf-drain
-          ##byte-wbuf-drain)
+          (if adaptive?
+              (##make-adaptive-byte-wbuf-drain)
+              ##byte-wbuf-drain))
          (rdevice-condvar
           (and (##not (##fx= rkind (macro-none-kind)))
                (##make-io-condvar-for-reading rdevice)))
@@ -6667,6 +6841,364 @@
                       (write-bytevector u8vect port start end)
                       (##write-bytevector u8vect p start end))))))))))
 
+(define-prim (##port-copy!
+              in
+              out
+              #!optional
+              (count (macro-absent-obj)))
+
+  ;; Copies count bytes, or all the bytes up to the end-of-file when
+  ;; count is absent, from the byte input-port in to the byte
+  ;; output-port out and returns the number of bytes copied.  When
+  ;; both ports are device ports, the buffers of the ports are
+  ;; emptied and then the operating system transfers the bytes
+  ;; directly between the devices (with sendfile or splice) if the
+  ;; devices allow it.  Otherwise the bytes are copied through a
+  ;; u8vector.
+
+  (##declare (not interrupts-enabled))
+
+  (define os-chunk-len 1048576) ;; max bytes transferred by one system call
+  (define buf-len 65536)        ;; length of u8vector used otherwise
+
+  (define (remaining n)
+    (if (##eq? count (macro-absent-obj))
+        os-chunk-len
+        (##fxmin os-chunk-len (##fx- count n))))
+
+  (define (buffered-copy n)
+    (let ((buf (##make-u8vector buf-len)))
+      (let loop ((n n))
+        (let ((len (##fxmin buf-len (remaining n))))
+          (if (##fx< 0 len)
+              (let ((k (##read-subu8vector buf 0 len in 1)))
+                (if (##fx< 0 k)
+                    (begin
+                      (##write-subu8vector buf 0 k out)
+                      (loop (##fx+ n k)))
+                    n))
+              n)))))
+
+  (define (unbuffer n)
+
+    ;; write the bytes in the byte buffer of in to out
+
+    (macro-lock-and-check-input-port-character-buffer-empty
+     in
+     (port-copy! in out count)
+     (let* ((byte-rlo
+             (macro-byte-port-rlo in))
+            (byte-rhi
+             (macro-byte-port-rhi in))
+            (k
+             (##fxmin (##fx- byte-rhi byte-rlo) (remaining n))))
+       (if (##fx< 0 k)
+           (let ((buf (##make-u8vector k)))
+             (##subu8vector-move!
+              (macro-byte-port-rbuf in)
+              byte-rlo
+              (##fx+ byte-rlo k)
+              buf
+              0)
+             (macro-byte-port-rlo-set! in (##fx+ byte-rlo k))
+             (macro-port-mutex-unlock! in)
+             (##write-subu8vector buf 0 k out)
+             (##fx+ n k))
+           (begin
+             (macro-port-mutex-unlock! in)
+             n)))))
+
+  (define (lock-ports!)
+
+    ;; The mutexes of the ports are locked in a fixed order to prevent
+    ;; cross locking with a copy in the other direction.
+
+    (define (ordered-locking p1 p2)
+      (macro-port-mutex-lock! p1)
+      (if (##not (##eq? p1 p2)) (macro-port-mutex-lock! p2)))
+
+    (if (##object-before? in out)
+        (ordered-locking in out)
+        (ordered-locking out in)))
+
+  (define (unlock-ports!)
+    (if (##not (##eq? in out))
+        (macro-port-mutex-unlock! out))
+    (macro-port-mutex-unlock! in))
+
+  (define (direct-copy n)
+    (let ((len (remaining n)))
+      (if (##not (##fx< 0 len))
+          n
+          (begin
+            (lock-ports!)
+            (if (or (##fx< (macro-byte-port-rlo in)
+                           (macro-byte-port-rhi in))
+                    (##fx< (macro-character-port-rlo in)
+                           (macro-character-port-rhi in))
+                    (##fx< (macro-byte-port-wlo out)
+                           (macro-byte-port-whi out))
+                    (##fx< (macro-character-port-wlo out)
+                           (macro-character-port-whi out)))
+
+                ;; another thread has used the buffers of the ports,
+                ;; so empty them again
+
+                (begin
+                  (unlock-ports!)
+                  (copy n))
+
+                (let ((result
+                       (##os-device-stream-copy
+                        (macro-device-port-rdevice-condvar in)
+                        (macro-device-port-wdevice-condvar out)
+                        len)))
+                  (unlock-ports!)
+                  (cond ((##not result)
+
+                         ;; no bytes are available from in, so wait
+
+                         (if (or (##wait-for-io!
+                                  (macro-device-port-rdevice-condvar in)
+                                  (macro-port-rtimeout in))
+                                 ((macro-port-rtimeout-thunk in)))
+                             (direct-copy n)
+                             n))
+
+                        ((##fx= result ##err-code-EAGAIN)
+
+                         ;; out can't accept bytes, so wait
+
+                         (if (or (##wait-for-io!
+                                  (macro-device-port-wdevice-condvar out)
+                                  (macro-port-wtimeout out))
+                                 ((macro-port-wtimeout-thunk out)))
+                             (direct-copy n)
+                             n))
+
+                        ((##fx= result ##err-code-EINTR)
+                         (direct-copy n))
+
+                        ((##fx< result 0)
+
+                         ;; the devices don't allow a direct transfer,
+                         ;; or it failed, so copy through the ports
+                         ;; which will report errors that persist
+
+                         (buffered-copy n))
+
+                        ((##fx= result 0) ;; end-of-file reached?
+                         n)
+
+                        (else
+                         (direct-copy (##fx+ n result))))))))))
+
+  (define (copy n)
+    (let ((n (unbuffer n)))
+      (if (and (macro-device-input-port? in)
+               (macro-device-output-port? out))
+          (begin
+            (##force-output out)
+            (direct-copy n))
+          (buffered-copy n))))
+
+  (copy 0))
+
+(define-prim (port-copy!
+              in
+              out
+              #!optional
+              (count (macro-absent-obj)))
+  (macro-force-vars (in out count)
+    (macro-check-byte-input-port
+      in
+      1
+      (port-copy! in out count)
+      (macro-check-byte-output-port
+        out
+        2
+        (port-copy! in out count)
+        (if (##eq? count (macro-absent-obj))
+            (##port-copy! in out)
+            (macro-check-index
+              count
+              3
+              (port-copy! in out count)
+              (##port-copy! in out count)))))))
+
+;;;----------------------------------------------------------------------------
+
+;;; Windows on memory-mapped files.
+
+;; A file opened with the mmap: setting is read from a mapping of the
+;; file in memory.  A window gives access to a range of bytes of the
+;; mapping without copying them to the heap.  The mapping stays valid
+;; while a window refers to it, even when the port is closed.
+
+(define ##mmap-window-tags '(mmap-window))
+
+(define-prim (##mmap-window? obj)
+  (and (##foreign? obj)
+       (##eq? (##foreign-tags obj) ##mmap-window-tags)))
+
+(define-prim (mmap-window? obj)
+  (macro-force-vars (obj)
+    (##mmap-window? obj)))
+
+(define-prim (##port-mmap-length port)
+
+  ;; The port's mutex is held because closing the port unmaps the
+  ;; file.
+
+  (##declare (not interrupts-enabled))
+  (macro-port-mutex-lock! port)
+  (let ((result
+         (##os-device-stream-mmap-length
+          (macro-condvar-name (macro-device-port-rdevice-condvar port)))))
+    (macro-port-mutex-unlock! port)
+    result))
+
+(define-prim (##port-mmap-window port start end)
+
+  ;; The range was checked against the length of the mapping, but the
+  ;; port may have been closed since, in which case the error is
+  ;; reported by the device.
+
+  (##declare (not interrupts-enabled))
+  (macro-port-mutex-lock! port)
+  (let ((result
+         (##os-device-stream-mmap-window
+          (macro-condvar-name (macro-device-port-rdevice-condvar port))
+          start
+          end
+          ##mmap-window-tags)))
+    (macro-port-mutex-unlock! port)
+    (if (##fixnum? result)
+        (##raise-os-exception #f result port-mmap-window port start end)
+        result)))
+
+(define-prim (port-mmap-window
+              port
+              #!optional
+              (start (macro-absent-obj))
+              (end (macro-absent-obj)))
+  (##declare (not interrupts-enabled))
+  (macro-force-vars (port start end)
+    (macro-check-device-input-port
+      port
+      1
+      (port-mmap-window port start end)
+      (let ((len (##port-mmap-length port)))
+        (if (##not len) ;; file was not opened with the mmap: setting?
+            (##raise-os-exception
+             #f
+             ##err-code-unimplemented
+             port-mmap-window
+             port
+             start
+             end)
+            (if (##eq? start (macro-absent-obj))
+                (##port-mmap-window port 0 len)
+                (macro-check-index-range-incl
+                  start
+                  2
+                  0
+                  len
+                  (port-mmap-window port start end)
+                  (if (##eq? end (macro-absent-obj))
+                      (##port-mmap-window port start len)
+                      (macro-check-index-range-incl
+                        end
+                        3
+                        start
+                        len
+                        (port-mmap-window port start end)
+                        (##port-mmap-window port start end))))))))))
+
+(define-prim (mmap-window-length window)
+  (macro-force-vars (window)
+    (macro-check-mmap-window window 1 (mmap-window-length window)
+      (##os-mmap-window-length window))))
+
+(define-prim (mmap-window-ref window k)
+  (macro-force-vars (window k)
+    (macro-check-mmap-window window 1 (mmap-window-ref window k)
+      (macro-check-index-range
+        k
+        2
+        0
+        (##os-mmap-window-length window)
+        (mmap-window-ref window k)
+        (##os-mmap-window-ref window k)))))
+
+(define-prim (mmap-window-index
+              window
+              byte
+              #!optional
+              (start (macro-absent-obj))
+              (end (macro-absent-obj)))
+  (macro-force-vars (window byte start end)
+    (macro-check-mmap-window
+      window
+      1
+      (mmap-window-index window byte start end)
+      (macro-check-exact-unsigned-int8
+        byte
+        2
+        (mmap-window-index window byte start end)
+        (let ((len (##os-mmap-window-length window)))
+          (if (##eq? start (macro-absent-obj))
+              (##os-mmap-window-index window byte 0 len)
+              (macro-check-index-range-incl
+                start
+                3
+                0
+                len
+                (mmap-window-index window byte start end)
+                (if (##eq? end (macro-absent-obj))
+                    (##os-mmap-window-index window byte start len)
+                    (macro-check-index-range-incl
+                      end
+                      4
+                      start
+                      len
+                      (mmap-window-index window byte start end)
+                      (##os-mmap-window-index window byte start end))))))))))
+
+(define-prim (##mmap-window->u8vector window start end)
+  (let ((u8vect (##make-u8vector (##fx- end start))))
+    (##os-mmap-window-copy! window start end u8vect 0)
+    u8vect))
+
+(define-prim (mmap-window->u8vector
+              window
+              #!optional
+              (start (macro-absent-obj))
+              (end (macro-absent-obj)))
+  (macro-force-vars (window start end)
+    (macro-check-mmap-window
+      window
+      1
+      (mmap-window->u8vector window start end)
+      (let ((len (##os-mmap-window-length window)))
+        (if (##eq? start (macro-absent-obj))
+            (##mmap-window->u8vector window 0 len)
+            (macro-check-index-range-incl
+              start
+              2
+              0
+              len
+              (mmap-window->u8vector window start end)
+              (if (##eq? end (macro-absent-obj))
+                  (##mmap-window->u8vector window start len)
+                  (macro-check-index-range-incl
+                    end
+                    3
+                    start
+                    len
+                    (mmap-window->u8vector window start end)
+                    (##mmap-window->u8vector window start end)))))))))
+
 (define-prim (open-input-bytevector u8vect)
   (macro-force-vars (u8vect)
     (macro-check-u8vector
@@ -6815,8 +7347,12 @@
                                    (##port-char-buf-len
                                     (macro-port-rkind port)
                                     (macro-unbuffered? roptions))))
-                              (if (##not (##fx= (##string-length rbuf)
-                                                new-char-buf-len))
+                              (if (if (macro-unbuffered? roptions)
+                                      (##not (##fx= (##string-length rbuf)
+                                                    new-char-buf-len))
+                                      ;; keep buffers grown adaptively
+                                      (##fx< (##string-length rbuf)
+                                             new-char-buf-len))
                                   (let ((new-rbuf
                                          (##make-string new-char-buf-len)))
                                     (macro-character-port-rchars-set!
@@ -6833,8 +7369,12 @@
                                    (##port-char-buf-len
                                     (macro-port-wkind port)
                                     (macro-unbuffered? woptions))))
-                              (if (##not (##fx= (##string-length wbuf)
-                                                new-char-buf-len))
+                              (if (if (macro-unbuffered? woptions)
+                                      (##not (##fx= (##string-length wbuf)
+                                                    new-char-buf-len))
+                                      ;; keep buffers grown adaptively
+                                      (##fx< (##string-length wbuf)
+                                             new-char-buf-len))
                                   (let ((new-wbuf
                                          (##make-string new-char-buf-len)))
                                     (macro-character-port-wchars-set!
@@ -7088,6 +7628,7 @@
      input-buffering:
      output-buffering:
      buffering:
+     buffer-size:
      input-readtable:
      output-readtable:
      readtable:)
@@ -7872,6 +8413,7 @@
       input-buffering:
       output-buffering:
       buffering:
+      buffer-size:
       input-readtable:
       output-readtable:
       readtable:
@@ -7899,6 +8441,7 @@
       input-buffering:
       output-buffering:
       buffering:
+      buffer-size:
       input-readtable:
       output-readtable:
       readtable:
@@ -9841,6 +10384,7 @@
      create:
      truncate:
      permissions:
+     mmap:
      output-width:
      input-char-encoding:
      output-char-encoding:
@@ -9855,6 +10399,7 @@
      input-buffering:
      output-buffering:
      buffering:
+     buffer-size:
      input-readtable:
      output-readtable:
      readtable:)
@@ -9877,6 +10422,7 @@
      eol-encoding:
      input-buffering:
      buffering:
+     buffer-size:
      input-readtable:
      readtable:)
    settings
@@ -9934,12 +10480,15 @@
         (if raise-os-exception?
             (##raise-os-exception #f device prim path-or-settings arg2)
             (cont device resolved-path))
-        (cont
-         (##make-device-port-from-single-device
-          (##path-unresolve resolved-path)
-          device
-          psettings)
-         resolved-path))))
+        (begin
+          (if (##fx= (macro-psettings-mmap psettings) (macro-mmap))
+              (##os-device-stream-mmap device)) ;; reads files normally on error
+          (cont
+           (##make-device-port-from-single-device
+            (##path-unresolve resolved-path)
+            device
+            psettings)
+           resolved-path)))))
 
 (define-prim (##path-reference path relative-to-path)
   (##path-expand
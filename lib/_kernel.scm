@@ -2210,6 +2210,10 @@ end-of-code
    "___set_parallelism_level (___INT(___ARG1)); ___RESULT = ___VOID;"
    level))
 
+(define-prim (##get-parallelism-max)
+  (##declare (not interrupts-enabled))
+  (##c-code "___RESULT = ___FIX(___GSTATE->setup_params.parallelism_max);"))
+
 (define-prim (##get-standard-level)
   (##declare (not interrupts-enabled))
   (##c-code "___RESULT = ___FIX(___get_standard_level ());"))
@@ -4054,6 +4058,228 @@ end-of-code
         (##process-statistics))
       v)))
 
+;; (##gc-telemetry reset?) returns an f64vector with the GC telemetry
+;; counters, which are always maintained by the collector:
+;;
+;;  0: number of collections
+;;  1-6: total real time of the phases of the collections
+;;       (setup, mark strong, mark weak, wills, gc hash tables, cleanup)
+;;  7-12: real time of the phases of the latest collection
+;; 13: longest pause
+;; 14: total bytes copied          15: bytes copied by latest collection
+;; 16: total still bytes freed     17: still bytes freed by latest collection
+;; 18-49: pause histogram, slot 18+i counts the pauses in the range
+;;        [2^(i-1),2^i) microseconds (slot 18 counts pauses < 1 us)
+;; 50+4p: bytes scanned by processor p during the latest collection
+;; 51+4p: heap chunks processor p stole from others during the latest
+;;        collection
+;; 52+4p: wills processed by processor p during the latest collection
+;; 53+4p: wills that processor p found to be executable during the
+;;        latest collection
+;;
+;; When reset? is true the pause histogram and longest pause are
+;; cleared after being read, so that successive calls report the
+;; pauses of each polling interval.
+
+(define-prim (##gc-telemetry #!optional (reset? #f))
+  (##declare (not interrupts-enabled))
+  (let ((v (##c-code #<<end-of-code
+
+   ___virtual_machine_state ___vms = ___VMSTATE_FROM_PSTATE(___ps);
+   int np = ___vms->processor_count;
+   ___SCMOBJ result;
+
+   ___FRAME_STORE_RA(___R0)
+   ___W_ALL
+   result = ___EXT(___alloc_scmobj) (___ps, ___sF64VECTOR, (50+4*np)<<3);
+   ___R_ALL
+   ___SET_R0(___FRAME_FETCH_RA)
+
+   if (!___FIXNUMP(result))
+   {
+      int i;
+
+      ___F64VECTORSET(result,___FIX(0),___vms->mem.nb_gcs_)
+
+      for (i=0; i<___GC_NB_PHASES; i++)
+        {
+          ___F64VECTORSET(result,___FIX(1+i),___vms->mem.gc_phase_time_[i])
+          ___F64VECTORSET(result,___FIX(7+i),___vms->mem.latest_gc_phase_time_[i])
+        }
+
+      ___F64VECTORSET(result,___FIX(13),___vms->mem.gc_max_pause_)
+      ___F64VECTORSET(result,___FIX(14),___vms->mem.gc_bytes_copied_)
+      ___F64VECTORSET(result,___FIX(15),___vms->mem.latest_gc_movable_)
+      ___F64VECTORSET(result,___FIX(16),___vms->mem.gc_bytes_still_freed_)
+      ___F64VECTORSET(result,___FIX(17),___vms->mem.latest_gc_bytes_still_freed_)
+
+      for (i=0; i<___GC_PAUSE_HIST_LENGTH; i++)
+        ___F64VECTORSET(result,___FIX(18+i),___vms->mem.gc_pause_hist_[i])
+
+      for (i=0; i<np; i++)
+        {
+          ___processor_state ps = ___PSTATE_FROM_PROCESSOR_ID(i,___vms);
+          ___F64VECTORSET(result,___FIX(50+4*i),___CAST(___F64,ps->mem.gc_words_scanned_) * ___WS)
+          ___F64VECTORSET(result,___FIX(51+4*i),___CAST(___F64,ps->mem.gc_chunks_stolen_))
+          ___F64VECTORSET(result,___FIX(52+4*i),___CAST(___F64,ps->mem.gc_wills_))
+          ___F64VECTORSET(result,___FIX(53+4*i),___CAST(___F64,ps->mem.gc_wills_executable_))
+        }
+
+      if (___ARG1 != ___FAL)
+        {
+          for (i=0; i<___GC_PAUSE_HIST_LENGTH; i++)
+            ___vms->mem.gc_pause_hist_[i] = 0.0;
+          ___vms->mem.gc_max_pause_ = 0.0;
+        }
+
+      ___still_obj_refcount_dec (result);
+   }
+
+   ___RESULT = result;
+
+end-of-code
+
+     reset?)))
+    (if (##fixnum? v)
+      (begin
+        (##raise-heap-overflow-exception)
+        (##gc-telemetry reset?))
+      v)))
+
+;; (##alloc-sampling-start! interval) clears the allocation samples and
+;; starts sampling an allocation every time a processor has allocated
+;; interval bytes, and (##alloc-sampling-stop!) stops the sampling.
+;; (##alloc-sampling-samples) returns a vector containing consecutive
+;; triples of the return address in the allocating code (#f when
+;; unknown), the subtype of the objects allocated and the number of
+;; samples.  Each sample accounts for (##alloc-sampling-interval)
+;; bytes.  (##alloc-sampling-lost) is the number of samples that did
+;; not fit in the sampling table.  The interval must be a positive
+;; fixnum.
+
+(define-prim (##alloc-sampling-start! interval)
+  (##declare (not interrupts-enabled))
+  (cond ((##not (##fixnum? interval))
+         (##raise-type-exception
+          1
+          'fixnum
+          ##alloc-sampling-start!
+          (##list interval)))
+        ((##not (##fx< 0 interval))
+         (##raise-range-exception 1 ##alloc-sampling-start! interval))
+        (else
+         (##c-code #<<end-of-code
+
+   ___alloc_sampling_set (___ps, ___INT(___ARG1));
+   ___RESULT = ___VOID;
+
+end-of-code
+
+          interval))))
+
+(define-prim (##alloc-sampling-stop!)
+  (##declare (not interrupts-enabled))
+  (##c-code #<<end-of-code
+
+   ___alloc_sampling_set (___ps, 0);
+   ___RESULT = ___VOID;
+
+end-of-code
+))
+
+(define-prim (##alloc-sampling-interval)
+  (##declare (not interrupts-enabled))
+  (##c-code #<<end-of-code
+
+   ___virtual_machine_state ___vms = ___VMSTATE_FROM_PSTATE(___ps);
+
+   ___RESULT = ___FIX(___vms->mem.alloc_sample_interval_ << ___LWS);
+
+end-of-code
+))
+
+(define-prim (##alloc-sampling-lost)
+  (##declare (not interrupts-enabled))
+  (##c-code #<<end-of-code
+
+   ___virtual_machine_state ___vms = ___VMSTATE_FROM_PSTATE(___ps);
+
+   ___RESULT = ___FIX(___vms->mem.alloc_samples_lost_);
+
+end-of-code
+))
+
+(define-prim (##alloc-sampling-samples)
+  (##declare (not interrupts-enabled))
+  (let* ((v (##make-vector
+             (##fx* 3 (##c-code "___RESULT = ___FIX(___ALLOC_SAMPLE_TABLE_LENGTH);"))
+             #f))
+         (n (##c-code
+             "___RESULT = ___FIX(___alloc_sampling_get (___ps, ___ARG1));"
+             v)))
+    (##vector-shrink! v (##fx* 3 n))
+    v))
+
+;; (##gc-census) performs a garbage collection that takes a census of
+;; the live objects (excluding permanent objects) and returns a vector
+;; with the result:
+;;
+;;  2s:   number of live objects of subtype s (0 <= s < 32)
+;;  2s+1: bytes occupied by the live objects of subtype s
+;;  64+3i, 65+3i, 66+3i: a structure type descriptor, the number of
+;;        live structures of that type and the bytes they occupy
+;;
+;; A type descriptor of #t in the last triple stands for the structures
+;; that were not counted by type because there were too many types.
+
+(define-prim (##gc-census)
+  (##declare (not interrupts-enabled))
+  (let ((v (##c-code #<<end-of-code
+
+   ___virtual_machine_state ___vms = ___VMSTATE_FROM_PSTATE(___ps);
+   int np = ___vms->processor_count;
+   ___SCMOBJ result;
+
+   ___FRAME_STORE_RA(___R0)
+   ___W_ALL
+
+   ___vms->mem.gc_census_ = 1;
+
+   if (___garbage_collect (___PSP 0))
+     result = ___FIX(___HEAP_OVERFLOW_ERR);
+   else
+     result = ___EXT(___alloc_scmobj)
+                (___ps,
+                 ___sVECTOR,
+                 (2*(1<<___SB)+3*___GC_CENSUS_NB_TYPES*np+3)<<___LWS);
+
+   ___vms->mem.gc_census_ = 0;
+
+   ___R_ALL
+   ___SET_R0(___FRAME_FETCH_RA)
+
+   if (!___FIXNUMP(result))
+     {
+       ___gc_census_get (___ps, result);
+       ___still_obj_refcount_dec (result);
+     }
+
+   ___RESULT = result;
+
+end-of-code
+)))
+    (if (##fixnum? v)
+      (begin
+        (##raise-heap-overflow-exception)
+        (##gc-census))
+      (let loop ((i 64))
+        (if (and (##fx< i (##vector-length v))
+                 (##vector-ref v i))
+            (loop (##fx+ i 3))
+            (begin
+              (##vector-shrink! v i)
+              v))))))
+
 (define-prim (##process-times)
   (##declare (not interrupts-enabled))
   (let ((v
@@ -4275,6 +4501,59 @@ end-of-code
             scheme-object   ;; bytes written (fixnum)
    "___os_device_stream_write"))
 
+(define-prim ##os-device-stream-copy
+  (c-lambda (scheme-object  ;; rdev_condvar
+             scheme-object  ;; wdev_condvar
+             scheme-object) ;; len
+            scheme-object   ;; bytes transferred (fixnum) or #f
+   "___os_device_stream_copy"))
+
+(define-prim ##os-device-stream-mmap
+  (c-lambda (scheme-object) ;; dev
+            scheme-object   ;; error code (fixnum)
+   "___os_device_stream_mmap"))
+
+(define-prim ##os-device-stream-mmap-length
+  (c-lambda (scheme-object) ;; dev
+            scheme-object   ;; length (fixnum) or #f if not mapped
+   "___os_device_stream_mmap_length"))
+
+(define-prim ##os-device-stream-mmap-window
+  (c-lambda (scheme-object  ;; dev
+             scheme-object  ;; start
+             scheme-object  ;; end
+             scheme-object) ;; tags
+            scheme-object   ;; window (foreign) or error code (fixnum)
+   "___os_device_stream_mmap_window"))
+
+(define-prim ##os-mmap-window-length
+  (c-lambda (scheme-object) ;; window
+            scheme-object   ;; length (fixnum)
+   "___os_mmap_window_length"))
+
+(define-prim ##os-mmap-window-ref
+  (c-lambda (scheme-object  ;; window
+             scheme-object) ;; i
+            scheme-object   ;; byte (fixnum)
+   "___os_mmap_window_ref"))
+
+(define-prim ##os-mmap-window-index
+  (c-lambda (scheme-object  ;; window
+             scheme-object  ;; byte
+             scheme-object  ;; start
+             scheme-object) ;; end
+            scheme-object   ;; index (fixnum) or #f
+   "___os_mmap_window_index"))
+
+(define-prim ##os-mmap-window-copy!
+  (c-lambda (scheme-object  ;; window
+             scheme-object  ;; start
+             scheme-object  ;; end
+             scheme-object  ;; u8vect
+             scheme-object) ;; at
+            scheme-object   ;; void
+   "___os_mmap_window_copy"))
+
 (define-prim ##os-device-stream-width
   (c-lambda (scheme-object) ;; dev_condvar
             scheme-object   ;; width (fixnum)
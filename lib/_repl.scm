@@ -5406,6 +5406,155 @@
 
           result)))))
 
+(define ##subtype-names
+  '#(vector pair ratnum cpxnum structure boxvalues meroon jazz
+     symbol keyword frame continuation promise weak procedure return
+     #f #f foreign string s8vector u8vector s16vector u16vector
+     s32vector u32vector f32vector s64vector u64vector f64vector
+     flonum bignum))
+
+(define-prim (##alloc-sampling-report #!optional (port (macro-absent-obj)))
+  (macro-force-vars (port)
+    (let ((p
+           (if (##eq? port (macro-absent-obj))
+               (##repl-output-port)
+               port)))
+      (macro-check-output-port p 1 (##alloc-sampling-report p)
+        (let* ((samples (##alloc-sampling-samples))
+               (interval (##alloc-sampling-interval))
+               (lost (##alloc-sampling-lost)))
+
+          ;; Merge the samples of the return addresses of each
+          ;; procedure, and sort by decreasing number of samples.
+
+          (define (merge i entries)
+            (if (##fx< i (##vector-length samples))
+                (let* ((ra (##vector-ref samples i))
+                       (name (and ra (##subprocedure-parent-name ra)))
+                       (subtype (##vector-ref samples (##fx+ i 1)))
+                       (count (##vector-ref samples (##fx+ i 2))))
+                  (let loop ((lst entries))
+                    (cond ((##null? lst)
+                           (merge (##fx+ i 3)
+                                  (##cons (##vector name subtype count)
+                                          entries)))
+                          ((and (##eq? (##vector-ref (##car lst) 0) name)
+                                (##eq? (##vector-ref (##car lst) 1) subtype))
+                           (##vector-set! (##car lst)
+                                          2
+                                          (##+ (##vector-ref (##car lst) 2)
+                                               count))
+                           (merge (##fx+ i 3) entries))
+                          (else
+                           (loop (##cdr lst))))))
+                (##vector-sort!
+                 (lambda (x y) (##< (##vector-ref y 2) (##vector-ref x 2)))
+                 (##list->vector entries))))
+
+          (let* ((entries (merge 0 '()))
+                 (total
+                  (let loop ((i (##fx- (##vector-length entries) 1)) (n lost))
+                    (if (##fx< i 0)
+                        n
+                        (loop (##fx- i 1)
+                              (##+ n (##vector-ref (##vector-ref entries i) 2)))))))
+
+            (##write-string "(alloc-sampling interval: " p)
+            (##write interval p)
+            (##write-string " bytes samples: " p)
+            (##write total p)
+            (##write-string " lost: " p)
+            (##write lost p)
+            (##write-string ")" p)
+            (##newline p)
+
+            (let loop ((i 0))
+              (if (##fx< i (##vector-length entries))
+                  (let* ((e (##vector-ref entries i))
+                         (name (##vector-ref e 0))
+                         (subtype (##vector-ref e 1))
+                         (count (##vector-ref e 2)))
+                    (##write-string "    " p)
+                    (##write (##* count interval) p)
+                    (##write-string " bytes " p)
+                    (##write (##quotient (##* 100 count) total) p)
+                    (##write-string "% " p)
+                    (if name
+                        (##write name p)
+                        (##write-string "?" p))
+                    (##write-string " " p)
+                    (##write (or (##vector-ref ##subtype-names
+                                               subtype)
+                                 subtype)
+                             p)
+                    (##newline p)
+                    (loop (##fx+ i 1))))))
+
+          (##void))))))
+
+(define-prim (##gc-census-report
+              #!optional
+              (n 20)
+              (port (macro-absent-obj)))
+  (macro-force-vars (n port)
+    (let ((p
+           (if (##eq? port (macro-absent-obj))
+               (##repl-output-port)
+               port)))
+      (macro-check-output-port p 2 (##gc-census-report n p)
+        (let* ((census (##gc-census))
+               (subtypes
+                (let loop ((s 31) (lst '()))
+                  (if (##fx< s 0)
+                      lst
+                      (loop (##fx- s 1)
+                            (if (##eq? (##vector-ref census (##fx* 2 s)) 0)
+                                lst
+                                (##cons (##vector
+                                         (or (##vector-ref ##subtype-names s) s)
+                                         (##vector-ref census (##fx* 2 s))
+                                         (##vector-ref census (##fx+ (##fx* 2 s) 1)))
+                                        lst))))))
+               (types
+                (let loop ((i (##fx- (##vector-length census) 3)) (lst '()))
+                  (if (##fx< i 64)
+                      lst
+                      (loop (##fx- i 3)
+                            (##cons (##vector
+                                     (let ((type (##vector-ref census i)))
+                                       (if (##eq? type #t)
+                                           '<other-types>
+                                           (##type-name type)))
+                                     (##vector-ref census (##fx+ i 1))
+                                     (##vector-ref census (##fx+ i 2)))
+                                    lst))))))
+
+          ;; Print the n entries with the most bytes, each as the bytes,
+          ;; the number of objects and the subtype or type name.
+
+          (define (print-entries title entries)
+            (let ((v (##vector-sort!
+                      (lambda (x y) (##< (##vector-ref y 2) (##vector-ref x 2)))
+                      (##list->vector entries))))
+              (##write-string title p)
+              (##newline p)
+              (let loop ((i 0))
+                (if (and (##fx< i (##vector-length v)) (##< i n))
+                    (let ((e (##vector-ref v i)))
+                      (##write-string "    " p)
+                      (##write (##vector-ref e 2) p)
+                      (##write-string " bytes " p)
+                      (##write (##vector-ref e 1) p)
+                      (##write-string " objects " p)
+                      (##write (##vector-ref e 0) p)
+                      (##newline p)
+                      (loop (##fx+ i 1)))))))
+
+          (print-entries "(gc-census subtypes)" subtypes)
+          (print-entries "(gc-census structure types)" types)
+
+          (##void))))))
+
 ;;;----------------------------------------------------------------------------
 
 ;; REPL server.
@@ -156,6 +156,9 @@
 (define-check-type condvar (macro-type-condvar)
   macro-condvar?)
 
+(define-check-type rwlock (macro-type-rwlock)
+  macro-rwlock?)
+
 (define-check-type tgroup (macro-type-tgroup)
   macro-tgroup?)
 
@@ -214,6 +217,12 @@
 ;;   3) One field of the sentinel always points to the leftmost node of
 ;;      the red-black tree.  This allows constant time access to the
 ;;      "minimum" node, which is a frequent operation of priority queues.
+;;      Another field may point to the rightmost node.  A node that
+;;      goes before the leftmost node, or not before the rightmost
+;;      node, is attached directly to it without descending from the
+;;      root (this is the common case for timeouts that are all
+;;      relative to the current time, and for threads of equal
+;;      priority in a run queue).
 ;;
 ;;   4) Several cases are handled specially (see the code for details).
 ;;
@@ -389,6 +398,13 @@
                      (,leftmost-set! rbtree node)))
                  `())
 
+             ;; check if rightmost must be updated (when tree was empty)
+
+             ,@(if rightmost
+                 `((if (##eq? x rbtree)
+                     (,rightmost-set! rbtree node)))
+                 `())
+
              (fixup!))
            (insert-below! left-x)))
 
@@ -420,7 +436,31 @@
        (,left-set! node rbtree)
        (,right-set! node rbtree)
 
-       (insert-left! (,left rbtree) rbtree)
+       ;; Descending from the root always goes left down to the
+       ;; leftmost node when the node goes before it, and always goes
+       ;; right down to the rightmost node when the node does not go
+       ;; before it, so the node can be attached to them directly.
+
+       ,(cond ((and leftmost rightmost)
+               `(let ((leftmost-node (,leftmost rbtree)))
+                  (cond ((##eq? leftmost-node rbtree)
+                         (insert-left! (,left rbtree) rbtree))
+                        ((,before? node leftmost-node)
+                         (insert-left! (,left leftmost-node) leftmost-node))
+                        (else
+                         (let ((rightmost-node (,rightmost rbtree)))
+                           (if (,before? node rightmost-node)
+                             (insert-left! (,left rbtree) rbtree)
+                             (insert-right! (,right rightmost-node)
+                                            rightmost-node)))))))
+              (leftmost
+               `(let ((leftmost-node (,leftmost rbtree)))
+                  (if (and (##not (##eq? leftmost-node rbtree))
+                           (,before? node leftmost-node))
+                    (insert-left! (,left leftmost-node) leftmost-node)
+                    (insert-left! (,left rbtree) rbtree))))
+              (else
+               `(insert-left! (,left rbtree) rbtree)))
 
        (,parent-set! rbtree rbtree)))
 
@@ -506,6 +546,15 @@
                              right-node))))
                       `())
 
+                  ;; check if rightmost must be updated
+
+                  ,@(if rightmost
+                      `((if (##eq? node (,rightmost rbtree))
+                          (,rightmost-set!
+                           rbtree
+                           parent-node)))
+                      `())
+
                   (,parent-set! right-node parent-node)
                   (,(update-parent!) parent-node node right-node)
 
@@ -1010,6 +1059,42 @@
  macro-thread-btq-container-set!
 )
 
+;; The run queue of a processor is a blocked thread queue that also
+;; keeps track of its rightmost thread, so that threads of equal
+;; priority are added to the end of the run queue in constant time.
+;; Mutexes and condition variables have no field for it, so the run
+;; queue has its own instantiation of the red-black tree operations.
+
+(##define-macro (macro-rq-rightmost node)       `(macro-struct-slot 22 ,node))
+(##define-macro (macro-rq-rightmost-set! node x)`(macro-struct-slot 22 ,node ,x))
+
+(define-rbtree
+ implement-rq
+ macro-rq-init!
+ macro-thread->rq
+ ##rq-insert!
+ ##rq-remove!
+ ##rq-reposition!
+ macro-rq-singleton?
+ macro-btq-color
+ macro-btq-color-set!
+ macro-btq-parent
+ macro-btq-parent-set!
+ macro-btq-left
+ macro-btq-left-set!
+ macro-btq-right
+ macro-btq-right-set!
+ macro-thread-higher-prio?
+ #f
+ #f
+ macro-btq-leftmost
+ macro-btq-leftmost-set!
+ macro-rq-rightmost
+ macro-rq-rightmost-set!
+ macro-thread-btq-container
+ macro-thread-btq-container-set!
+)
+
 (macro-define-syntax macro-if-btq-next
   (lambda (stx)
     (syntax-case stx ()
@@ -1108,6 +1193,8 @@
 (##define-macro (macro-toq-right-set! node x)  `(macro-struct-slot 13 ,node ,x))
 (##define-macro (macro-toq-leftmost node)      `(macro-struct-slot 13 ,node))
 (##define-macro (macro-toq-leftmost-set! node x)`(macro-struct-slot 13 ,node ,x))
+(##define-macro (macro-toq-rightmost node)     `(macro-struct-slot 15 ,node))
+(##define-macro (macro-toq-rightmost-set! node x)`(macro-struct-slot 15 ,node ,x))
 
 (define-rbtree
  implement-toq
@@ -1130,8 +1217,8 @@
  #f
  macro-toq-leftmost
  macro-toq-leftmost-set!
- #f
- #f
+ macro-toq-rightmost
+ macro-toq-rightmost-set!
  macro-thread-toq-container
  macro-thread-toq-container-set!
 )
@@ -1842,6 +1929,46 @@
        (macro-btq-init! condvar)
        condvar)))
 
+;;; Representation of reader-writer locks.
+
+(define-type rwlock
+  id: 74bf2633-6dc6-44b9-8e0b-d3b6ea448bd3
+  type-exhibitor: macro-type-rwlock
+  constructor: macro-construct-rwlock
+  implementer: implement-type-rwlock
+  predicate: macro-rwlock?
+  opaque:
+  macros:
+  prefix: macro-
+
+  unprintable:
+
+  ;; field readers is the number of threads holding the lock for
+  ;; reading, or -1 when a thread holds it for writing
+  mutex
+  read-condvar
+  write-condvar
+  readers
+  waiting-writers
+
+  (name
+   macro-rwlock-name
+   macro-rwlock-name-set!)
+  (specific
+   macro-rwlock-specific
+   macro-rwlock-specific-set!)
+)
+
+(##define-macro (macro-make-rwlock name)
+  `(macro-construct-rwlock
+    (macro-make-mutex #f)
+    (macro-make-condvar #f)
+    (macro-make-condvar #f)
+    0
+    0
+    ,name
+    (##void)))
+
 ;;; Representation of thread groups.
 
 (define-type thread-groups
@@ -2009,12 +2136,17 @@
   ;; fields 10 to 12 are for maintaining a timeout queue of threads
   ;; field 13 is the leftmost thread in the timeout queue of threads
   ;; field 14 is the thread currently running on this processor
+  ;; field 15 is the rightmost thread in the timeout queue of threads
   ;; field 16 is for storing the current time, heartbeat interval and a
   ;; temporary float
   ;; fields 17 and 18 are the deq links of blocked processors
   ;; field 19 is the id of the processor
   ;; field 20 is the head of the queue of pending high-level interrupts
   ;; field 21 is the tail of the queue of pending high-level interrupts
+  ;; field 22 is the rightmost thread in the queue of runnable threads
+  ;; field 23 is the seed for choosing victims of work stealing
+  ;; field 24 is the count of run queues visited to steal threads
+  ;; field 25 is the count of threads stolen from other processors
   lock1
   condvar-deq-next
   condvar-deq-prev
@@ -2029,13 +2161,17 @@
   toq-left
   toq-leftmost
   current-thread
-  unused-field15
+  toq-rightmost
   floats
   processor-deq-next
   processor-deq-prev
   id
   interrupts-head
   interrupts-tail
+  rq-rightmost
+  steal-seed
+  steal-attempts
+  threads-stolen
 )
 
 (##define-macro (macro-make-floats)
@@ -2081,9 +2217,13 @@
            #f
            ,id
            '()
-           '())))
+           '()
+           #f
+           (##fx+ ,id 1)
+           0
+           0)))
      (macro-btq-deq-init! processor)
-     (macro-btq-init! processor)
+     (macro-rq-init! processor)
      (macro-toq-init! processor)
      (macro-processor-deq-init! processor)
      processor))
@@ -2095,12 +2235,15 @@
       processor
       (macro-make-floats))
      (macro-btq-deq-init! processor)
-     (macro-btq-init! processor)
+     (macro-rq-init! processor)
      (macro-toq-init! processor)
      (macro-processor-deq-init! processor)
      (macro-processor-id-set! processor id)
      (macro-processor-interrupts-head-set! processor '())
      (macro-processor-interrupts-tail-set! processor '())
+     (macro-processor-steal-seed-set! processor (##fx+ id 1))
+     (macro-processor-steal-attempts-set! processor 0)
+     (macro-processor-threads-stolen-set! processor 0)
      processor))
 
 ;;;----------------------------------------------------------------------------
@@ -2411,6 +2554,9 @@
 (define-check-type condvar (macro-type-condvar)
   macro-condvar?)
 
+(define-check-type rwlock (macro-type-rwlock)
+  macro-rwlock?)
+
 (define-check-type tgroup (macro-type-tgroup)
   macro-tgroup?)
 
@@ -2466,6 +2612,12 @@
 ;;   3) One field of the sentinel always points to the leftmost node of
 ;;      the red-black tree.  This allows constant time access to the
 ;;      "minimum" node, which is a frequent operation of priority queues.
+;;      Another field may point to the rightmost node.  A node that
+;;      goes before the leftmost node, or not before the rightmost
+;;      node, is attached directly to it without descending from the
+;;      root (this is the common case for timeouts that are all
+;;      relative to the current time, and for threads of equal
+;;      priority in a run queue).
 ;;
 ;;   4) Several cases are handled specially (see the code for details).
 ;;
@@ -2641,6 +2793,13 @@
                      (,leftmost-set! rbtree node)))
                  `())
 
+             ;; check if rightmost must be updated (when tree was empty)
+
+             ,@(if rightmost
+                 `((if (##eq? x rbtree)
+                     (,rightmost-set! rbtree node)))
+                 `())
+
              (fixup!))
            (insert-below! left-x)))
 
@@ -2672,7 +2831,31 @@
        (,left-set! node rbtree)
        (,right-set! node rbtree)
 
-       (insert-left! (,left rbtree) rbtree)
+       ;; Descending from the root always goes left down to the
+       ;; leftmost node when the node goes before it, and always goes
+       ;; right down to the rightmost node when the node does not go
+       ;; before it, so the node can be attached to them directly.
+
+       ,(cond ((and leftmost rightmost)
+               `(let ((leftmost-node (,leftmost rbtree)))
+                  (cond ((##eq? leftmost-node rbtree)
+                         (insert-left! (,left rbtree) rbtree))
+                        ((,before? node leftmost-node)
+                         (insert-left! (,left leftmost-node) leftmost-node))
+                        (else
+                         (let ((rightmost-node (,rightmost rbtree)))
+                           (if (,before? node rightmost-node)
+                             (insert-left! (,left rbtree) rbtree)
+                             (insert-right! (,right rightmost-node)
+                                            rightmost-node)))))))
+              (leftmost
+               `(let ((leftmost-node (,leftmost rbtree)))
+                  (if (and (##not (##eq? leftmost-node rbtree))
+                           (,before? node leftmost-node))
+                    (insert-left! (,left leftmost-node) leftmost-node)
+                    (insert-left! (,left rbtree) rbtree))))
+              (else
+               `(insert-left! (,left rbtree) rbtree)))
 
        (,parent-set! rbtree rbtree)))
 
@@ -2758,6 +2941,15 @@
                              right-node))))
                       `())
 
+                  ;; check if rightmost must be updated
+
+                  ,@(if rightmost
+                      `((if (##eq? node (,rightmost rbtree))
+                          (,rightmost-set!
+                           rbtree
+                           parent-node)))
+                      `())
+
                   (,parent-set! right-node parent-node)
                   (,(update-parent!) parent-node node right-node)
 
@@ -3261,6 +3453,42 @@
  #f
 )
 
+;; The run queue of a processor is a blocked thread queue that also
+;; keeps track of its rightmost thread, so that threads of equal
+;; priority are added to the end of the run queue in constant time.
+;; Mutexes and condition variables have no field for it, so the run
+;; queue has its own instantiation of the red-black tree operations.
+
+(##define-macro (macro-rq-rightmost node)       `(macro-struct-slot 22 ,node))
+(##define-macro (macro-rq-rightmost-set! node x)`(macro-struct-slot 22 ,node ,x))
+
+(define-rbtree
+ implement-rq
+ macro-rq-init!
+ macro-thread->rq
+ ##rq-insert!
+ ##rq-remove!
+ ##rq-reposition!
+ macro-rq-singleton?
+ macro-btq-color
+ macro-btq-color-set!
+ macro-btq-parent
+ macro-btq-parent-set!
+ macro-btq-left
+ macro-btq-left-set!
+ macro-btq-right
+ macro-btq-right-set!
+ macro-thread-higher-prio?
+ #f
+ #f
+ macro-btq-leftmost
+ macro-btq-leftmost-set!
+ macro-rq-rightmost
+ macro-rq-rightmost-set!
+ #f
+ #f
+)
+
 ;;; Define operations on blocked thread queue double-ended-queues.
 
 (define-deq
@@ -3304,6 +3532,8 @@
 (##define-macro (macro-toq-right-set! node x)  `(macro-struct-slot 13 ,node ,x))
 (##define-macro (macro-toq-leftmost node)      `(macro-struct-slot 13 ,node))
 (##define-macro (macro-toq-leftmost-set! node x)`(macro-struct-slot 13 ,node ,x))
+(##define-macro (macro-toq-rightmost node)     `(macro-struct-slot 15 ,node))
+(##define-macro (macro-toq-rightmost-set! node x)`(macro-struct-slot 15 ,node ,x))
 
 (define-rbtree
  implement-toq
@@ -3326,8 +3556,8 @@
  #f
  macro-toq-leftmost
  macro-toq-leftmost-set!
- #f
- #f
+ macro-toq-rightmost
+ macro-toq-rightmost-set!
  #f
  #f
 )
@@ -3540,7 +3770,9 @@
      (##declare (not interrupts-enabled))
 
      (if (macro-btq-parent thread)
-       (##thread-btq-remove! thread))))
+       (if (macro-processor? (macro-thread->btq thread))
+         (##rq-remove! thread)
+         (##thread-btq-remove! thread)))))
 
 (##define-macro (macro-thread-toq-remove-if-in-toq! thread)
   `(let ((thread ,thread))
@@ -3852,6 +4084,46 @@
        (macro-btq-init! condvar)
        condvar)))
 
+;;; Representation of reader-writer locks.
+
+(define-type rwlock
+  id: 74bf2633-6dc6-44b9-8e0b-d3b6ea448bd3
+  type-exhibitor: macro-type-rwlock
+  constructor: macro-construct-rwlock
+  implementer: implement-type-rwlock
+  predicate: macro-rwlock?
+  opaque:
+  macros:
+  prefix: macro-
+
+  unprintable:
+
+  ;; field readers is the number of threads holding the lock for
+  ;; reading, or -1 when a thread holds it for writing
+  mutex
+  read-condvar
+  write-condvar
+  readers
+  waiting-writers
+
+  (name
+   macro-rwlock-name
+   macro-rwlock-name-set!)
+  (specific
+   macro-rwlock-specific
+   macro-rwlock-specific-set!)
+)
+
+(##define-macro (macro-make-rwlock name)
+  `(macro-construct-rwlock
+    (macro-make-mutex #f)
+    (macro-make-condvar #f)
+    (macro-make-condvar #f)
+    0
+    0
+    ,name
+    (##void)))
+
 ;;; Representation of thread groups.
 
 (define-type thread-groups
@@ -4022,12 +4294,17 @@
   ;; fields 10 to 12 are for maintaining a timeout queue of threads
   ;; field 13 is the leftmost thread in the timeout queue of threads
   ;; field 14 is the thread currently running on this processor
+  ;; field 15 is the rightmost thread in the timeout queue of threads
   ;; field 16 is for storing the current time, heartbeat interval and a
   ;; temporary float
   ;; fields 17 and 18 are the deq links of blocked processors
   ;; field 19 is the id of the processor
   ;; field 20 is the head of the queue of pending high-level interrupts
   ;; field 21 is the tail of the queue of pending high-level interrupts
+  ;; field 22 is the rightmost thread in the queue of runnable threads
+  ;; field 23 is the seed for choosing victims of work stealing
+  ;; field 24 is the count of run queues visited to steal threads
+  ;; field 25 is the count of threads stolen from other processors
   lock1
   condvar-deq-next
   condvar-deq-prev
@@ -4042,13 +4319,17 @@
   toq-left
   toq-leftmost
   current-thread
-  unused-field15
+  toq-rightmost
   floats
   processor-deq-next
   processor-deq-prev
   id
   interrupts-head
   interrupts-tail
+  rq-rightmost
+  steal-seed
+  steal-attempts
+  threads-stolen
 )
 
 (##define-macro (macro-make-floats)
@@ -4094,9 +4375,13 @@
            #f
            ,id
            '()
-           '())))
+           '()
+           #f
+           (##fx+ ,id 1)
+           0
+           0)))
      (macro-btq-deq-init! processor)
-     (macro-btq-init! processor)
+     (macro-rq-init! processor)
      (macro-toq-init! processor)
      (macro-processor-deq-init! processor)
      processor))
@@ -4110,12 +4395,15 @@
                    (macro-inexact-+0)
                    (macro-inexact-+0)))
      (macro-btq-deq-init! processor)
-     (macro-btq-init! processor)
+     (macro-rq-init! processor)
      (macro-toq-init! processor)
      (macro-processor-deq-init! processor)
      (macro-processor-id-set! processor id)
      (macro-processor-interrupts-head-set! processor '())
      (macro-processor-interrupts-tail-set! processor '())
+     (macro-processor-steal-seed-set! processor (##fx+ id 1))
+     (macro-processor-steal-attempts-set! processor 0)
+     (macro-processor-threads-stolen-set! processor 0)
      processor))
 
 ;;;----------------------------------------------------------------------------
@@ -183,6 +183,7 @@
 (implement-check-type-thread)
 (implement-check-type-mutex)
 (implement-check-type-condvar)
+(implement-check-type-rwlock)
 (implement-check-type-tgroup)
 
 ;;;----------------------------------------------------------------------------
@@ -192,6 +193,7 @@
 (implement-type-thread)
 (implement-type-mutex)
 (implement-type-condvar)
+(implement-type-rwlock)
 (implement-type-tgroups)
 (implement-type-tgroup)
 
@@ -656,6 +658,7 @@
 ;;; Implementation of blocked thread queues and timeout queues.
 
 (implement-btq) ;; defines ##btq-insert!, etc
+(implement-rq) ;; defines ##rq-insert!, etc
 (implement-toq) ;; defines ##toq-insert!, etc
 
 ;;;----------------------------------------------------------------------------
@@ -679,7 +682,7 @@
 ;;; Operations on processor run queues.
 
 (##define-macro (macro-add-thread-to-run-queue-of-current-processor-without-locking! thread)
-  `(##btq-insert! (macro-current-processor) ,thread))
+  `(##rq-insert! (macro-current-processor) ,thread))
 
 (##define-macro (macro-add-thread-to-run-queue-of-current-processor! thread)
   `(let ((thread ,thread))
@@ -697,12 +700,33 @@
           ;; the thread is pinned to a processor, so add it to that run queue
           (let ((processor pinned))
             (macro-lock-processor! processor)
-            (##btq-insert! processor thread)
+            (##rq-insert! processor thread)
             (macro-unlock-processor! processor)
             (##wait-abort! processor)))
-        (begin
-          ;; the thread is not pinned, so add it to the current processor
-          (macro-add-thread-to-run-queue-of-current-processor! thread)))))
+        (let ((last-processor (macro-thread-last-processor thread)))
+          (if (and last-processor
+                   (##not (##eq? last-processor (macro-current-processor)))
+                   (macro-trylock-current-vm!))
+              (let loop ((processor (macro-processor-deq-head (macro-current-vm))))
+                (cond ((##eq? processor (macro-current-vm))
+                       ;; the processor that last ran the thread is busy
+                       (macro-unlock-current-vm!)
+                       (macro-add-thread-to-run-queue-of-current-processor! thread))
+                      ((##eq? processor last-processor)
+                       ;; the processor that last ran the thread is
+                       ;; idle, so add it there to benefit from a
+                       ;; warm cache
+                       (macro-processor-deq-remove! processor)
+                       (macro-unlock-current-vm!)
+                       (macro-lock-processor! processor)
+                       (##rq-insert! processor thread)
+                       (macro-unlock-processor! processor)
+                       (##wait-abort-no-remove! processor))
+                      (else
+                       (loop (macro-processor-deq-next processor)))))
+              (begin
+                ;; the thread is not pinned, so add it to the current processor
+                (macro-add-thread-to-run-queue-of-current-processor! thread)))))))
 
 (##define-macro (macro-add-thread-to-run-queue-of-current-processor-preferably! thread)
   `(##add-thread-to-run-queue-of-current-processor-preferably-out-of-line! ,thread))
@@ -720,7 +744,7 @@
           ;; the thread is pinned to a processor, so add it to that run queue
           (let ((processor pinned))
             (macro-lock-processor! processor)
-            (##btq-insert! processor thread)
+            (##rq-insert! processor thread)
             (macro-unlock-processor! processor)
             (##wait-abort! processor)))
         (if (##not (macro-trylock-current-vm!))
@@ -736,7 +760,7 @@
                     (macro-processor-deq-remove! processor)
                     (macro-unlock-current-vm!)
                     (macro-lock-processor! processor)
-                    (##btq-insert! processor thread)
+                    (##rq-insert! processor thread)
                     (macro-unlock-processor! processor)
                     (##wait-abort-no-remove! processor))))))))
 
@@ -787,7 +811,7 @@
                 ;; The blocked thread queue is the run queue of a processor.
 
                 (macro-lock-processor! btq)
-                (##btq-remove! thread) ;; remove thread from btq
+                (##rq-remove! thread) ;; remove thread from run queue
                 (macro-unlock-processor! btq)
 
                 (continue))
@@ -978,6 +1002,81 @@
   (##declare (not interrupts-enabled))
   (##thread-start! (##make-thread thunk)))
 
+;; The procedure ##make-future implements the special form future.
+;; The body is started as a task on the run queue of some processor
+;; so that idle processors can execute it in parallel.  The result is
+;; a promise, so touch waits for the task.  When the task has not yet
+;; been started by the time it is touched, the toucher evaluates the
+;; body itself, which costs little more than a procedure call.  The
+;; first field of the claim vector holds #f (unclaimed), started
+;; (claimed by the task), touched (claimed by a toucher), escaped (the
+;; body evaluated by a toucher escaped) or a box containing the result
+;; of the body evaluated by a toucher.  Once claimed the task never
+;; runs the body, and after an escape only another touch evaluates it
+;; again, as for a delay.  The other touchers block on the condition
+;; variable of the claim vector while a toucher evaluates the body.
+;; An exception raised by the body in the task is raised again by
+;; touch, rather than wrapped in an uncaught-exception.
+
+(define-prim (##make-future thunk)
+  (let* ((claim
+          (##vector #f (##make-mutex #f) (##make-condvar #f)))
+         (task
+          (##thread
+           (lambda ()
+             (if (##not (##vector-cas! claim 0 'started #f))
+                 (thunk)
+                 (##void))))))
+    (##make-delay-promise
+     (lambda ()
+       (let loop ()
+         (let ((state (##vector-cas! claim 0 'touched #f)))
+           (cond ((or (##not state)
+                      (and (##eq? state 'escaped)
+                           (##eq? (##vector-cas! claim 0 'touched 'escaped)
+                                  'escaped)))
+                  (##dynamic-wind
+                   (lambda () #f)
+                   (lambda ()
+                     (let ((result (thunk)))
+                       (##vector-set! claim 0 (##box result))
+                       result))
+                   (lambda ()
+                     (##declare (not interrupts-enabled))
+                     (let ((mutex (##vector-ref claim 1)))
+                       (macro-mutex-lock! mutex #f (macro-current-thread))
+                       ;; the body escaped, but the task must not run it
+                       (if (##eq? (##vector-ref claim 0) 'touched)
+                           (##vector-set! claim 0 'escaped))
+                       (##condvar-signal! (##vector-ref claim 2) #t)
+                       (macro-mutex-unlock! mutex)))))
+                 ((##eq? state 'started)
+                  (##with-exception-catcher
+                   (lambda (exc)
+                     (##raise
+                      (if (macro-uncaught-exception? exc)
+                          (macro-uncaught-exception-reason exc)
+                          exc)))
+                   (lambda ()
+                     (##thread-join! task
+                                     (macro-absent-obj)
+                                     (macro-absent-obj)))))
+                 ((##box? state)
+                  (##unbox state))
+                 (else
+                  ;; another toucher is evaluating the body
+                  (let ()
+                    (##declare (not interrupts-enabled))
+                    (let ((mutex (##vector-ref claim 1)))
+                      (macro-mutex-lock! mutex #f (macro-current-thread))
+                      (if (##eq? (##vector-ref claim 0) 'touched)
+                          (##mutex-signal-and-condvar-wait!
+                           mutex
+                           (##vector-ref claim 2)
+                           #t)
+                          (macro-mutex-unlock! mutex))))
+                  (loop)))))))))
+
 ;;;----------------------------------------------------------------------------
 
 ;; The procedure make-thread creates and returns an initialized
@@ -2380,7 +2479,11 @@
 
   (if (macro-btq-parent thread)
     (begin
-      (##btq-reposition! thread) ;; reposition thread in the btq it is in
+      (let ((btq (macro-thread->btq thread)))
+        ;; reposition thread in the btq it is in
+        (if (macro-processor? btq)
+          (##rq-reposition! thread)
+          (##btq-reposition! thread)))
 
       ;; make sure the owner of the blocked thread queue
       ;; (i.e. mutex, condvar, etc) inherits the thread's effective
@@ -2585,6 +2688,26 @@
         (loop (##cons processor lst)
               (macro-processor-deq-next processor)))))
 
+;; The procedure ##processor-steal-counts returns a vector with one
+;; element per processor of the current VM.  Each element is a pair
+;; of the number of run queues visited to steal threads and the
+;; number of threads stolen by that processor.  The counters are read
+;; without locking so the result is approximate.
+
+(define-prim (##processor-steal-counts)
+  (let* ((n (##current-vm-processor-count))
+         (result (##make-vector n '())))
+    (let loop ((i 0))
+      (if (##fx< i n)
+          (let ((processor (##processor i)))
+            (##vector-set!
+             result
+             i
+             (##cons (macro-processor-steal-attempts processor)
+                     (macro-processor-threads-stolen processor)))
+            (loop (##fx+ i 1)))
+          result))))
+
 ;; The procedure ##thread-poll-devices! checks without blocking if any
 ;; of the devices on which the processor is waiting for an IO
 ;; operation to become possible are now ready to perform the IO
@@ -2737,6 +2860,79 @@
          (macro-unlock-current-thread!)
          (resume-thunk))))))
 
+;;; The procedure ##next-steal-victim-offset! advances the current
+;;; processor's steal seed (a small linear congruential generator
+;;; that stays within fixnum range on all platforms) and returns the
+;;; offset of the first victim to visit when stealing.
+
+(define-prim (##next-steal-victim-offset!)
+
+  (##declare (not interrupts-enabled))
+
+  ;; Assumes that exclusive access to the processor has been acquired.
+
+  (let* ((processor (macro-current-processor))
+         (seed (##fxmodulo
+                (##fx+ (##fx* (macro-processor-steal-seed processor) 75) 74)
+                65537))
+         (n (##fx- (##current-vm-processor-count) 1)))
+    (macro-processor-steal-seed-set! processor seed)
+    (if (##fx> n 0)
+        (##fxmodulo seed n)
+        0)))
+
+;;; The procedure ##steal-half-of-run-queue! is called after a thread
+;;; was stolen from the head of the run queue of victim-processor.  It
+;;; moves up to half of the threads remaining there to the run queue
+;;; of the current processor, but no more than 32 threads.  Moving
+;;; stops at the first thread that is pinned or that can't be locked
+;;; without blocking.
+
+(define-prim (##steal-half-of-run-queue! victim-processor)
+
+  (##declare (not interrupts-enabled))
+
+  ;; Assumes that exclusive access to the current processor and to
+  ;; victim-processor has been acquired.
+
+  ;; The run queue doesn't keep its length, so it is counted by a
+  ;; walk of the tree while both processors are locked.  The walk
+  ;; stops after max-count threads to bound the time the victim is
+  ;; locked, which caps a steal at max-count/2 threads.  The thief
+  ;; steals again the next time its own run queue is empty.
+
+  (define max-count 64)
+
+  (define (run-queue-length btq)
+    (let count ((node (macro-btq-left btq)) (n 0))
+      (if (or (##eq? node btq) (##fx>= n max-count))
+          n
+          (count (macro-btq-right node)
+                 (count (macro-btq-left node) (##fx+ n 1))))))
+
+  (let ((processor (macro-current-processor)))
+
+    (define (done moved)
+      (macro-processor-threads-stolen-set!
+       processor
+       (##fx+ (macro-processor-threads-stolen processor) moved)))
+
+    (let loop ((i (##fxquotient (run-queue-length victim-processor) 2))
+               (moved 1)) ;; count the thread stolen by the caller
+      (macro-if-btq-next
+       victim-processor
+       next-thread
+       (if (and (##fx> i 0)
+                (##not (macro-thread-pinned next-thread))
+                (macro-trylock-thread! next-thread))
+           (begin
+             (##rq-remove! next-thread)
+             (##rq-insert! processor next-thread)
+             (macro-unlock-thread! next-thread)
+             (loop (##fx- i 1) (##fx+ moved 1)))
+           (done moved))
+       (done moved)))))
+
 ;;; The procedure ##thread-schedule! implements the central logic of
 ;;; the thread scheduler.  It is called by a processor when it needs
 ;;; to select a runnable thread to continue executing.  If no runnable
@@ -2805,7 +3001,7 @@
             ;; The thread is not runnable because it is terminated.
 
             ;; remove thread from processor's run queue
-            (##btq-remove! next-thread)
+            (##rq-remove! next-thread)
 
             ;; release low-level lock of thread
             (macro-unlock-thread! next-thread)
@@ -2823,7 +3019,7 @@
             ;; continue executing it.
 
             ;; remove thread from processor's run queue
-            (##btq-remove! next-thread)
+            (##rq-remove! next-thread)
 
             ;; resume execution of the thread (this sets the processor's
             ;; current thread, and the thread's last-processor field)
@@ -2845,17 +3041,30 @@
      ;; thread from the run queue of another processor.
 
      ;; Make a reasonable attempt to steal a thread from the run
-     ;; queues of other processors.
+     ;; queues of other processors.  The victims are visited in a
+     ;; round-robin order starting at a pseudo-random processor so
+     ;; that idle processors do not all converge on the same victim.
 
-     (let loop ((i (##fx- (##current-vm-processor-count) 1)))
+     (let loop ((i (##fx- (##current-vm-processor-count) 1))
+                (start (##next-steal-victim-offset!)))
        (if (##fx> i 0)
 
            (let* ((id
-                   (##fxmodulo (##fx+ (##current-processor-id) i)
+                   (##fxmodulo (##fx+ (##current-processor-id)
+                                      (##fx+ 1
+                                             (##fxmodulo
+                                              (##fx+ start i)
+                                              (##fx- (##current-vm-processor-count)
+                                                     1))))
                                (##current-vm-processor-count)))
                   (victim-processor
                    (##processor id)))
 
+             (let ((processor (macro-current-processor)))
+               (macro-processor-steal-attempts-set!
+                processor
+                (##fx+ (macro-processor-steal-attempts processor) 1)))
+
              ;; Try to lock the victim processor, but don't block.
 
              (if (##not (macro-trylock-processor! victim-processor))
@@ -2864,7 +3073,7 @@
 
                    ;; Try another victim rather than blocking.
 
-                   (loop (##fx- i 1)))
+                   (loop (##fx- i 1) start))
 
                  (begin
 
@@ -2897,12 +3106,19 @@
                             (macro-unlock-processor! victim-processor)
 
                             ;; try another victim processor
-                            (loop (##fx- i 1)))
+                            (loop (##fx- i 1) start))
 
                           (begin
 
                             ;; remove the thread from the run queue
-                            (##btq-remove! stolen-thread)
+                            (##rq-remove! stolen-thread)
+
+                            ;; move up to half of the remaining
+                            ;; threads of the victim to this
+                            ;; processor's run queue, so that a
+                            ;; backlog is rebalanced without
+                            ;; stealing again for each thread
+                            (##steal-half-of-run-queue! victim-processor)
 
                             ;; release low-level lock of processor
                             (macro-unlock-processor! victim-processor)
@@ -2931,7 +3147,7 @@
                       (macro-unlock-processor! victim-processor)
 
                       ;; try another victim processor
-                      (loop (##fx- i 1)))))))
+                      (loop (##fx- i 1) start))))))
 
            (begin
 
@@ -3137,7 +3353,7 @@
        ;;TODO: reenable
        ;;(macro-thread-unboost-and-clear-quantum-used! current-thread)
        (macro-thread-resume-thunk-set! current-thread ##thread-void-action!)
-       (##btq-insert! p current-thread)
+       (##rq-insert! p current-thread)
        (macro-unlock-processor! p)
        (##wait-abort! p)
        ;;TODO: fix this
@@ -3150,7 +3366,7 @@
 (define-prim (##thread-start-on! id thread)
   (##declare (not interrupts-enabled))
   (let ((p (##processor id)))
-    (##btq-insert! p thread)
+    (##rq-insert! p thread)
     (##wait-abort! p)
     ;;(macro-thread-reschedule-if-needed!)
     thread))
@@ -3158,13 +3374,64 @@
 (define (##cvmr n)
   (##current-vm-resize ##startup-processor! n))
 
+;; When the parallelism level is a range (-:pMIN-MAX or -:p=auto) the
+;; VM starts with MIN processors and a monitor thread adds processors,
+;; up to MAX, while the current ones are all busy.  Every
+;; ##parallelism-monitor-interval seconds the monitor checks, without
+;; locking, if there are no idle processors and some run queue is not
+;; empty.  The VM grows by one processor when this is the case for
+;; ##parallelism-monitor-hysteresis consecutive samples.  The VM never
+;; shrinks because the threads in the run queue of a reclaimed
+;; processor would be lost, and idle processors already block until
+;; there is work for them.
+
+(define ##parallelism-monitor-interval .1)
+(define ##parallelism-monitor-hysteresis 3)
+
+(define-prim (##current-vm-overloaded?)
+
+  (##declare (not interrupts-enabled))
+
+  (and (##eq? (macro-processor-deq-head (macro-current-vm))
+              (macro-current-vm)) ;; no idle processors?
+       (let ((n (##current-vm-processor-count)))
+         (let loop ((i 0))
+           (and (##fx< i n)
+                (macro-if-btq-next
+                 (##processor i)
+                 next
+                 #t
+                 (loop (##fx+ i 1))))))))
+
+(define (##parallelism-monitor! max)
+  (let loop ((busy 0))
+    (##thread-sleep! ##parallelism-monitor-interval)
+    (let ((n (##current-vm-processor-count)))
+      (if (##fx< n max)
+          (cond ((##not (##current-vm-overloaded?))
+                 (loop 0))
+                ((##fx< (##fx+ busy 1) ##parallelism-monitor-hysteresis)
+                 (loop (##fx+ busy 1)))
+                (else
+                 (##cvmr (##fx+ n 1))
+                 (if (##fx< n (##current-vm-processor-count))
+                     (loop 0)))))))) ;; stop when the VM can't grow
+
 (define (##startup-parallelism!)
   (let* ((level
           (##get-parallelism-level))
          (nb-procs
-          (if (##fx> level 0) level (##fx+ (##cpu-count) level))))
+          (if (##fx> level 0) level (##fx+ (##cpu-count) level)))
+         (max
+          (##get-parallelism-max)))
     (if (##fx> nb-procs 1)
-        (##cvmr nb-procs))))
+        (##cvmr nb-procs))
+    (if (##fx> max nb-procs)
+        (##thread-start!
+         (##make-root-thread
+          (lambda () (##parallelism-monitor! max))
+          'parallelism-monitor
+          (##make-tgroup 'parallelism-monitor #f))))))
 
 ;; The ##startup-threading! procedure initializes the thread system.
 ;; It creates the primordial thread, the primordial thread group and
@@ -3396,18 +3663,53 @@
        absrel-timeout
        timeout-val))))
 
+;; (##thread-receive-all) removes all the messages from the current
+;; thread's mailbox and returns them in a list in the order they were
+;; sent, without blocking (the list is empty when there are none).
+;; The mailbox cursor is rewound.
+
+(define-prim (##thread-receive-all)
+  (##declare (not interrupts-enabled))
+  (let* ((mb
+          (##thread-mailbox-get! (macro-current-thread)))
+         (fifo
+          (macro-mailbox-fifo mb)))
+    (macro-mailbox-cursor-set! mb #f)
+    (if (##pair? (macro-fifo-next fifo))
+      (let ((mutex (macro-mailbox-mutex mb)))
+        (macro-mutex-lock! mutex #f (macro-current-thread))
+        (let ((msgs (macro-fifo-remove-all! fifo)))
+          (macro-mutex-unlock! mutex)
+          (let ()
+            (declare (interrupts-enabled))
+            msgs)))
+      '())))
+
+(define-prim (thread-receive-all)
+  (##thread-receive-all))
+
 (define-prim (##thread-send thread obj)
   (##declare (not interrupts-enabled))
   (let* ((mb
           (##thread-mailbox-get! thread))
          (mutex
-          (macro-mailbox-mutex mb)))
+          (macro-mailbox-mutex mb))
+         (condvar
+          (macro-mailbox-condvar mb)))
     (##check-heap-limit) ;; prevent GC while mutex is locked
     (macro-mutex-lock! mutex #f (macro-current-thread))
     (macro-fifo-insert-at-tail! (macro-mailbox-fifo mb) obj)
-    (macro-mutex-unlock! mutex)
-    (##condvar-signal! (macro-mailbox-condvar mb) #f)
-    (##void)))
+
+    ;; A receiver only starts waiting on the condvar while it owns the
+    ;; mutex, so the condvar needs to be signaled only if the receiver
+    ;; was already waiting when the message was added.
+
+    (let ((receiver-waiting?
+           (##not (##eq? (macro-btq-leftmost condvar) condvar))))
+      (macro-mutex-unlock! mutex)
+      (if receiver-waiting?
+        (##condvar-signal! condvar #f))
+      (##void))))
 
 (define-prim (thread-send thread obj)
   (macro-force-vars (thread)
@@ -3591,6 +3893,44 @@
                 condvar
                 absrel-timeout))))))))
 
+;; The procedure ##mutex-spin-while-owner-running! busy waits until
+;; the mutex is no longer owned by a thread that is running on
+;; another processor, until an iteration limit is reached or until
+;; the timeout (#t or a point in time) is reached.  The current time
+;; is read before the first iteration and then only every few
+;; iterations.  The fields are read without acquiring the low-level
+;; locks, so the result is only a hint for the caller.
+
+(##define-macro (macro-mutex-spin-limit) 1000)
+(##define-macro (macro-mutex-spin-time-check-mask) 63)
+
+(define-prim (##mutex-spin-while-owner-running! mutex timeout)
+
+  (##declare (not interrupts-enabled))
+
+  (define (timeout-reached?)
+    (and (##not (##eq? timeout #t))
+         (begin
+           (macro-update-current-time!)
+           (##not (##fl< (macro-current-time
+                          (macro-thread-floats (macro-current-processor)))
+                         timeout)))))
+
+  (let loop ((i (macro-mutex-spin-limit)))
+    (if (and (##fx> i 0)
+             (##not (and (##fx= (##fxand (##fx- (macro-mutex-spin-limit) i)
+                                         (macro-mutex-spin-time-check-mask))
+                                0)
+                         (timeout-reached?))))
+        (let ((owner (macro-btq-owner mutex)))
+          (if (macro-mutex-thread-owner? owner)
+              (let ((processor (macro-thread-last-processor owner)))
+                (if (and processor
+                         (##not (##eq? processor (macro-current-processor)))
+                         (##eq? (macro-processor-current-thread processor)
+                                owner))
+                    (loop (##fx- i 1)))))))))
+
 ;; The call (##mutex-lock-out-of-line! mutex absrel-timeout new-owner)
 ;; causes the current thread to attempt locking the mutex.  The
 ;; current thread will wait up to the indicated timeout for the mutex
@@ -3635,6 +3975,27 @@
 
                  timeout)))))
 
+    ;; A timeout of 0, or one that has already passed, gives a timeout
+    ;; of #f and the mutex is only tried once, without spinning.
+
+    (if (and timeout
+             (macro-mutex-thread-owner? (macro-btq-owner mutex)))
+        (begin
+
+          ;; The mutex is owned by a thread.  If that thread is running
+          ;; on another processor it is likely to release the mutex
+          ;; soon, so spin for a while before blocking, which would
+          ;; cost a reschedule.  The spin stops when the timeout is
+          ;; reached.
+
+          ;; release low-level lock of mutex
+          (macro-unlock-mutex! mutex)
+
+          (##mutex-spin-while-owner-running! mutex timeout)
+
+          ;; acquire low-level lock of mutex
+          (macro-lock-mutex! mutex)))
+
     (let try-again ()
 
       ;; Try to lock mutex.
@@ -4460,6 +4821,219 @@
     (macro-check-condvar condvar 1 (condition-variable-broadcast! condvar)
       (##condvar-signal! condvar #t))))
 
+;;; User accessible primitives for reader-writer locks.
+
+;; A reader-writer lock is made of a mutex protecting its state and
+;; of two condition variables on which readers and writers wait.
+;; Waiting writers have precedence over new readers, so that a steady
+;; stream of readers cannot starve the writers.
+
+(define-prim (make-rwlock #!optional (n (macro-absent-obj)))
+
+  (##declare (not interrupts-enabled))
+
+  (macro-force-vars (n)
+    (let ((name
+           (if (##eq? n (macro-absent-obj))
+             (##void)
+             n)))
+      (##make-rwlock name))))
+
+(define-prim (##make-rwlock name)
+
+  (##declare (not interrupts-enabled))
+
+  (macro-make-rwlock name))
+
+(define-prim (rwlock? obj)
+
+  (##declare (not interrupts-enabled))
+
+  (macro-force-vars (obj)
+    (macro-rwlock? obj)))
+
+(define-prim (rwlock-name rwlock)
+
+  (##declare (not interrupts-enabled))
+
+  (macro-force-vars (rwlock)
+    (macro-check-rwlock rwlock 1 (rwlock-name rwlock)
+      (macro-rwlock-name rwlock))))
+
+(define-prim (rwlock-specific rwlock)
+
+  (##declare (not interrupts-enabled))
+
+  (macro-force-vars (rwlock)
+    (macro-check-rwlock rwlock 1 (rwlock-specific rwlock)
+      (macro-rwlock-specific rwlock))))
+
+(define-prim (rwlock-specific-set! rwlock obj)
+
+  (##declare (not interrupts-enabled))
+
+  (macro-force-vars (rwlock)
+    (macro-check-rwlock rwlock 1 (rwlock-specific-set! rwlock obj)
+      (begin
+        (macro-rwlock-specific-set! rwlock obj)
+        (##void)))))
+
+;; The call (##rwlock-lock! rwlock timeout write?) acquires the
+;; reader-writer lock for writing if write? is true and for reading
+;; otherwise.  The timeout is #t when there is no timeout and is
+;; otherwise computed by ##absrel-timeout->timeout.  The result is #f
+;; if the timeout is reached before the lock is acquired and #t
+;; otherwise.
+
+(define-prim (##rwlock-lock! rwlock timeout write?)
+
+  (##declare (not interrupts-enabled))
+
+  (let ((mutex (macro-rwlock-mutex rwlock)))
+
+    (macro-mutex-lock! mutex #f (macro-current-thread))
+
+    (if write?
+        (macro-rwlock-waiting-writers-set!
+         rwlock
+         (##fx+ (macro-rwlock-waiting-writers rwlock) 1)))
+
+    (let loop ()
+      (let ((readers (macro-rwlock-readers rwlock)))
+        (cond ((if write?
+                   (##fx= readers 0)
+                   (and (##fx>= readers 0)
+                        (##fx= (macro-rwlock-waiting-writers rwlock) 0)))
+               (if write?
+                   (begin
+                     (macro-rwlock-waiting-writers-set!
+                      rwlock
+                      (##fx- (macro-rwlock-waiting-writers rwlock) 1))
+                     (macro-rwlock-readers-set! rwlock -1))
+                   (macro-rwlock-readers-set! rwlock (##fx+ readers 1)))
+               (macro-mutex-unlock! mutex)
+               #t)
+              ((##mutex-signal-and-condvar-wait!
+                mutex
+                (if write?
+                    (macro-rwlock-write-condvar rwlock)
+                    (macro-rwlock-read-condvar rwlock))
+                timeout)
+               (macro-mutex-lock! mutex #f (macro-current-thread))
+               (loop))
+              (else
+               (macro-mutex-lock! mutex #f (macro-current-thread))
+               (if write?
+                   (let ((waiting-writers
+                          (##fx- (macro-rwlock-waiting-writers rwlock) 1)))
+                     (macro-rwlock-waiting-writers-set! rwlock waiting-writers)
+                     ;; readers held back by this writer may proceed
+                     (if (and (##fx= waiting-writers 0)
+                              (##fx>= (macro-rwlock-readers rwlock) 0))
+                         (##condvar-signal!
+                          (macro-rwlock-read-condvar rwlock)
+                          #t))))
+               (macro-mutex-unlock! mutex)
+               #f))))))
+
+;; The call (##rwlock-unlock! rwlock write?) releases a hold of the
+;; reader-writer lock for writing if write? is true and for reading
+;; otherwise.  The result is #f, and the lock is left unchanged, when
+;; the lock is not held in that mode, and #t otherwise.
+
+(define-prim (##rwlock-unlock! rwlock write?)
+
+  (##declare (not interrupts-enabled))
+
+  (let ((mutex (macro-rwlock-mutex rwlock)))
+
+    (macro-mutex-lock! mutex #f (macro-current-thread))
+
+    (let ((readers (macro-rwlock-readers rwlock)))
+      (if (if write?
+              (##fx< readers 0)
+              (##fx> readers 0))
+          (let ((readers
+                 (if write?
+                     0
+                     (##fx- readers 1))))
+            (macro-rwlock-readers-set! rwlock readers)
+            (if (##fx= readers 0)
+                (if (##fx> (macro-rwlock-waiting-writers rwlock) 0)
+                    (##condvar-signal! (macro-rwlock-write-condvar rwlock) #f)
+                    (##condvar-signal! (macro-rwlock-read-condvar rwlock) #t)))
+            (macro-mutex-unlock! mutex)
+            #t)
+          (begin
+            (macro-mutex-unlock! mutex)
+            #f)))))
+
+(define-prim (rwlock-read-lock!
+              rwlock
+              #!optional
+              (absrel-timeout (macro-absent-obj)))
+  (macro-force-vars (rwlock absrel-timeout)
+    (macro-check-rwlock
+     rwlock
+     1
+     (rwlock-read-lock! rwlock absrel-timeout)
+     (cond ((or (##eq? absrel-timeout (macro-absent-obj))
+                (##not absrel-timeout))
+            (##rwlock-lock! rwlock #t #f))
+           ((macro-absrel-time? absrel-timeout)
+            (##rwlock-lock!
+             rwlock
+             (##absrel-timeout->timeout absrel-timeout)
+             #f))
+           (else
+            (##fail-check-absrel-time-or-false
+             2
+             rwlock-read-lock!
+             rwlock
+             absrel-timeout))))))
+
+(define-prim (rwlock-write-lock!
+              rwlock
+              #!optional
+              (absrel-timeout (macro-absent-obj)))
+  (macro-force-vars (rwlock absrel-timeout)
+    (macro-check-rwlock
+     rwlock
+     1
+     (rwlock-write-lock! rwlock absrel-timeout)
+     (cond ((or (##eq? absrel-timeout (macro-absent-obj))
+                (##not absrel-timeout))
+            (##rwlock-lock! rwlock #t #t))
+           ((macro-absrel-time? absrel-timeout)
+            (##rwlock-lock!
+             rwlock
+             (##absrel-timeout->timeout absrel-timeout)
+             #t))
+           (else
+            (##fail-check-absrel-time-or-false
+             2
+             rwlock-write-lock!
+             rwlock
+             absrel-timeout))))))
+
+(define-prim (rwlock-read-unlock! rwlock)
+  (macro-force-vars (rwlock)
+    (macro-check-rwlock rwlock 1 (rwlock-read-unlock! rwlock)
+      (if (##rwlock-unlock! rwlock #f)
+          (##void)
+          (##raise-error-exception
+           "rwlock is not locked for reading"
+           (##list rwlock))))))
+
+(define-prim (rwlock-write-unlock! rwlock)
+  (macro-force-vars (rwlock)
+    (macro-check-rwlock rwlock 1 (rwlock-write-unlock! rwlock)
+      (if (##rwlock-unlock! rwlock #t)
+          (##void)
+          (##raise-error-exception
+           "rwlock is not locked for writing"
+           (##list rwlock))))))
+
 ;;; User accessible primitives for thread groups.
 
 (define-prim (thread-group? obj)
@@ -5497,6 +6071,7 @@
 (implement-check-type-thread)
 (implement-check-type-mutex)
 (implement-check-type-condvar)
+(implement-check-type-rwlock)
 (implement-check-type-tgroup)
 
 ;;;----------------------------------------------------------------------------
@@ -5506,6 +6081,7 @@
 (implement-type-thread)
 (implement-type-mutex)
 (implement-type-condvar)
+(implement-type-rwlock)
 (implement-type-tgroups)
 (implement-type-tgroup)
 
@@ -5965,6 +6541,7 @@
 ;;; Implementation of blocked thread queues and timeout queues.
 
 (implement-btq) ;; defines ##btq-insert!, etc
+(implement-rq) ;; defines ##rq-insert!, etc
 (implement-toq) ;; defines ##toq-insert!, etc
 
 ;;;----------------------------------------------------------------------------
@@ -6011,6 +6588,21 @@
   (##declare (not interrupts-enabled))
   (##thread-start! (##make-thread thunk)))
 
+;; The procedure ##make-future implements the special form future.
+;; With a single processor there is nothing to gain from starting a
+;; task, so the body is evaluated immediately and its result is
+;; returned in an already forced promise.  As for make-promise, a
+;; result that is a promise is returned as is, so that touch forces
+;; it as it would in the SMP runtime.
+
+(define-prim (##make-future thunk)
+  (let ((result (thunk)))
+    (if (##promise? result)
+        result
+        (let ((promise (##make-delay-promise #f)))
+          (##vector-set! (##promise-state promise) 0 result)
+          promise))))
+
 (define-prim (##make-thread
               thunk
               #!optional
@@ -6022,7 +6614,7 @@
 (define-prim (##thread-start! thread)
   (##declare (not interrupts-enabled))
   (macro-thread-exception?-set! thread #f)
-  (##btq-insert! (macro-current-processor) thread)
+  (##rq-insert! (macro-current-processor) thread)
   (macro-thread-reschedule-if-needed!)
   thread)
 
@@ -6129,7 +6721,11 @@
 
   (if (macro-btq-parent thread)
     (begin
-      (##btq-reposition! thread) ;; reposition thread in the btq it is in
+      (let ((btq (macro-thread->btq thread)))
+        ;; reposition thread in the btq it is in
+        (if (macro-processor? btq)
+          (##rq-reposition! thread)
+          (##btq-reposition! thread)))
 
       ;; make sure the owner of the blocked thread queue
       ;; (i.e. mutex, condvar, etc) inherits the thread's effective
@@ -6223,7 +6819,7 @@
                     (macro-thread-resume-thunk-set! leftmost ##thread-timeout-action!)
                     (macro-thread-btq-remove-if-in-btq! leftmost)
                     (##thread-toq-remove! leftmost)
-                    (##btq-insert! current-processor leftmost)
+                    (##rq-insert! current-processor leftmost)
                     (loop)))))))))
 
 (define-prim (##thread-check-devices! timeout)
@@ -6241,6 +6837,26 @@
             (##device-condvar-broadcast-no-reschedule! condvar))
           (loop next))))))
 
+;; The procedure ##processor-steal-counts returns a vector with one
+;; element per processor of the current VM.  Each element is a pair
+;; of the number of run queues visited to steal threads and the
+;; number of threads stolen by that processor.  The counters are read
+;; without locking so the result is approximate.
+
+(define-prim (##processor-steal-counts)
+  (let* ((n (##current-vm-processor-count))
+         (result (##make-vector n '())))
+    (let loop ((i 0))
+      (if (##fx< i n)
+          (let ((processor (##processor i)))
+            (##vector-set!
+             result
+             i
+             (##cons (macro-processor-steal-attempts processor)
+                     (macro-processor-threads-stolen processor)))
+            (loop (##fx+ i 1)))
+          result))))
+
 (define-prim (##thread-poll-devices!)
 
   (##declare (not interrupts-enabled))
@@ -6292,17 +6908,17 @@
           (macro-current-thread))
          (current-processor
           (macro-current-processor)))
-    (if (##eq? (macro-btq-singleton? current-processor) current-thread)
+    (if (##eq? (macro-rq-singleton? current-processor) current-thread)
       (begin
         ;; fast case where only one thread is runnable
         (macro-thread-unboost-and-clear-quantum-used! current-thread)
         (##void))
       (macro-thread-save!
        (lambda (current-thread)
-         (##btq-remove! current-thread)
+         (##rq-remove! current-thread)
          (macro-thread-unboost-and-clear-quantum-used! current-thread)
          (macro-thread-resume-thunk-set! current-thread ##thread-void-action!)
-         (##btq-insert! (macro-current-processor) current-thread)
+         (##rq-insert! (macro-current-processor) current-thread)
          (##thread-schedule!))))))
 
 (define-prim (##thread-reschedule!)
@@ -6325,7 +6941,7 @@
                (macro-thread-save!
                 (lambda (current-thread timeout)
                   (macro-thread-resume-thunk-set! current-thread ##thread-void-action!)
-                  (##btq-remove! current-thread)
+                  (##rq-remove! current-thread)
                   (macro-thread-unboost-and-clear-quantum-used!
                    current-thread)
                   (if (##not (##eq? timeout #t))
@@ -6532,7 +7148,7 @@
              (lambda (self) ((##vector-ref self 2)))
              thunk-returning-void))
 
-  (##btq-insert! (macro-current-processor) thread))
+  (##rq-insert! (macro-current-processor) thread))
 
 (define-prim (##thread-continuation-capture thread)
   (##thread-call
@@ -6710,7 +7326,7 @@
                                (if end-condvar
                                  (begin
                                    (macro-thread-resume-thunk-set! current-thread ##thread-void-action!)
-                                   (##btq-remove! current-thread)
+                                   (##rq-remove! current-thread)
                                    (macro-thread-boost-and-clear-quantum-used!
                                     current-thread)
                                    (##thread-btq-insert!
@@ -6879,7 +7495,7 @@
      (macro-current-processor)
      thread)
 
-    (##btq-insert! (macro-current-processor) thread)
+    (##rq-insert! (macro-current-processor) thread)
     )
 
   (##enable-interrupts!)
@@ -6932,7 +7548,7 @@
      (macro-current-processor)
      primordial-thread)
 
-    (##btq-insert! (macro-current-processor) primordial-thread)
+    (##rq-insert! (macro-current-processor) primordial-thread)
 
     (set! ##primordial-thread primordial-thread)
 
@@ -7103,18 +7719,53 @@
        absrel-timeout
        timeout-val))))
 
+;; (##thread-receive-all) removes all the messages from the current
+;; thread's mailbox and returns them in a list in the order they were
+;; sent, without blocking (the list is empty when there are none).
+;; The mailbox cursor is rewound.
+
+(define-prim (##thread-receive-all)
+  (##declare (not interrupts-enabled))
+  (let* ((mb
+          (##thread-mailbox-get! (macro-current-thread)))
+         (fifo
+          (macro-mailbox-fifo mb)))
+    (macro-mailbox-cursor-set! mb #f)
+    (if (##pair? (macro-fifo-next fifo))
+      (let ((mutex (macro-mailbox-mutex mb)))
+        (macro-mutex-lock! mutex #f (macro-current-thread))
+        (let ((msgs (macro-fifo-remove-all! fifo)))
+          (macro-mutex-unlock! mutex)
+          (let ()
+            (declare (interrupts-enabled))
+            msgs)))
+      '())))
+
+(define-prim (thread-receive-all)
+  (##thread-receive-all))
+
 (define-prim (##thread-send thread obj)
   (##declare (not interrupts-enabled))
   (let* ((mb
           (##thread-mailbox-get! thread))
          (mutex
-          (macro-mailbox-mutex mb)))
+          (macro-mailbox-mutex mb))
+         (condvar
+          (macro-mailbox-condvar mb)))
     (##check-heap-limit) ;; prevent GC while mutex is locked
     (macro-mutex-lock! mutex #f (macro-current-thread))
     (macro-fifo-insert-at-tail! (macro-mailbox-fifo mb) obj)
-    (macro-mutex-unlock! mutex)
-    (##condvar-signal! (macro-mailbox-condvar mb) #f)
-    (##void)))
+
+    ;; A receiver only starts waiting on the condvar while it owns the
+    ;; mutex, so the condvar needs to be signaled only if the receiver
+    ;; was already waiting when the message was added.
+
+    (let ((receiver-waiting?
+           (##not (##eq? (macro-btq-leftmost condvar) condvar))))
+      (macro-mutex-unlock! mutex)
+      (if receiver-waiting?
+        (##condvar-signal! condvar #f))
+      (##void))))
 
 (define-prim (thread-send thread obj)
   (macro-force-vars (thread)
@@ -7164,7 +7815,7 @@
 
                           (begin
                             (macro-thread-resume-thunk-set! current-thread ##thread-void-action!)
-                            (##btq-remove! current-thread)
+                            (##rq-remove! current-thread)
                             (macro-thread-boost-and-clear-quantum-used!
                              current-thread)
                             (macro-thread-result-set!
@@ -7231,7 +7882,7 @@
 
   (macro-thread-toq-remove-if-in-toq! thread)
 
-  (##btq-insert! (macro-current-processor) thread))
+  (##rq-insert! (macro-current-processor) thread))
 
 (define-prim (##mutex-signal-and-condvar-wait! mutex condvar timeout)
 
@@ -7243,7 +7894,7 @@
             (lambda (current-thread mutex condvar timeout)
               (macro-thread-resume-thunk-set! current-thread ##thread-void-action!)
 
-              (##btq-remove! current-thread)
+              (##rq-remove! current-thread)
               (macro-thread-boost-and-clear-quantum-used!
                current-thread)
               (##thread-btq-insert! condvar current-thread)
@@ -7275,7 +7926,7 @@
            (macro-thread-save!
             (lambda (current-thread condvar timeout)
               (macro-thread-resume-thunk-set! current-thread ##thread-void-action!)
-              (##btq-remove! current-thread)
+              (##rq-remove! current-thread)
               (macro-thread-boost-and-clear-quantum-used!
                current-thread)
               (##thread-btq-insert! condvar current-thread)
@@ -7330,7 +7981,7 @@
            ##thread-signaled-condvar-action!)
           (thread-trace 9 (##thread-btq-remove! leftmost))
           (macro-thread-toq-remove-if-in-toq! leftmost)
-          (##btq-insert! (macro-current-processor) leftmost)
+          (##rq-insert! (macro-current-processor) leftmost)
           (if broadcast?
             (loop)
             (##void)))
@@ -7949,6 +8600,219 @@
     (macro-check-condvar condvar 1 (condition-variable-broadcast! condvar)
       (##condvar-signal! condvar #t))))
 
+;;; User accessible primitives for reader-writer locks.
+
+;; A reader-writer lock is made of a mutex protecting its state and
+;; of two condition variables on which readers and writers wait.
+;; Waiting writers have precedence over new readers, so that a steady
+;; stream of readers cannot starve the writers.
+
+(define-prim (make-rwlock #!optional (n (macro-absent-obj)))
+
+  (##declare (not interrupts-enabled))
+
+  (macro-force-vars (n)
+    (let ((name
+           (if (##eq? n (macro-absent-obj))
+             (##void)
+             n)))
+      (##make-rwlock name))))
+
+(define-prim (##make-rwlock name)
+
+  (##declare (not interrupts-enabled))
+
+  (macro-make-rwlock name))
+
+(define-prim (rwlock? obj)
+
+  (##declare (not interrupts-enabled))
+
+  (macro-force-vars (obj)
+    (macro-rwlock? obj)))
+
+(define-prim (rwlock-name rwlock)
+
+  (##declare (not interrupts-enabled))
+
+  (macro-force-vars (rwlock)
+    (macro-check-rwlock rwlock 1 (rwlock-name rwlock)
+      (macro-rwlock-name rwlock))))
+
+(define-prim (rwlock-specific rwlock)
+
+  (##declare (not interrupts-enabled))
+
+  (macro-force-vars (rwlock)
+    (macro-check-rwlock rwlock 1 (rwlock-specific rwlock)
+      (macro-rwlock-specific rwlock))))
+
+(define-prim (rwlock-specific-set! rwlock obj)
+
+  (##declare (not interrupts-enabled))
+
+  (macro-force-vars (rwlock)
+    (macro-check-rwlock rwlock 1 (rwlock-specific-set! rwlock obj)
+      (begin
+        (macro-rwlock-specific-set! rwlock obj)
+        (##void)))))
+
+;; The call (##rwlock-lock! rwlock timeout write?) acquires the
+;; reader-writer lock for writing if write? is true and for reading
+;; otherwise.  The timeout is #t when there is no timeout and is
+;; otherwise computed by ##absrel-timeout->timeout.  The result is #f
+;; if the timeout is reached before the lock is acquired and #t
+;; otherwise.
+
+(define-prim (##rwlock-lock! rwlock timeout write?)
+
+  (##declare (not interrupts-enabled))
+
+  (let ((mutex (macro-rwlock-mutex rwlock)))
+
+    (macro-mutex-lock! mutex #f (macro-current-thread))
+
+    (if write?
+        (macro-rwlock-waiting-writers-set!
+         rwlock
+         (##fx+ (macro-rwlock-waiting-writers rwlock) 1)))
+
+    (let loop ()
+      (let ((readers (macro-rwlock-readers rwlock)))
+        (cond ((if write?
+                   (##fx= readers 0)
+                   (and (##fx>= readers 0)
+                        (##fx= (macro-rwlock-waiting-writers rwlock) 0)))
+               (if write?
+                   (begin
+                     (macro-rwlock-waiting-writers-set!
+                      rwlock
+                      (##fx- (macro-rwlock-waiting-writers rwlock) 1))
+                     (macro-rwlock-readers-set! rwlock -1))
+                   (macro-rwlock-readers-set! rwlock (##fx+ readers 1)))
+               (macro-mutex-unlock! mutex)
+               #t)
+              ((##mutex-signal-and-condvar-wait!
+                mutex
+                (if write?
+                    (macro-rwlock-write-condvar rwlock)
+                    (macro-rwlock-read-condvar rwlock))
+                timeout)
+               (macro-mutex-lock! mutex #f (macro-current-thread))
+               (loop))
+              (else
+               (macro-mutex-lock! mutex #f (macro-current-thread))
+               (if write?
+                   (let ((waiting-writers
+                          (##fx- (macro-rwlock-waiting-writers rwlock) 1)))
+                     (macro-rwlock-waiting-writers-set! rwlock waiting-writers)
+                     ;; readers held back by this writer may proceed
+                     (if (and (##fx= waiting-writers 0)
+                              (##fx>= (macro-rwlock-readers rwlock) 0))
+                         (##condvar-signal!
+                          (macro-rwlock-read-condvar rwlock)
+                          #t))))
+               (macro-mutex-unlock! mutex)
+               #f))))))
+
+;; The call (##rwlock-unlock! rwlock write?) releases a hold of the
+;; reader-writer lock for writing if write? is true and for reading
+;; otherwise.  The result is #f, and the lock is left unchanged, when
+;; the lock is not held in that mode, and #t otherwise.
+
+(define-prim (##rwlock-unlock! rwlock write?)
+
+  (##declare (not interrupts-enabled))
+
+  (let ((mutex (macro-rwlock-mutex rwlock)))
+
+    (macro-mutex-lock! mutex #f (macro-current-thread))
+
+    (let ((readers (macro-rwlock-readers rwlock)))
+      (if (if write?
+              (##fx< readers 0)
+              (##fx> readers 0))
+          (let ((readers
+                 (if write?
+                     0
+                     (##fx- readers 1))))
+            (macro-rwlock-readers-set! rwlock readers)
+            (if (##fx= readers 0)
+                (if (##fx> (macro-rwlock-waiting-writers rwlock) 0)
+                    (##condvar-signal! (macro-rwlock-write-condvar rwlock) #f)
+                    (##condvar-signal! (macro-rwlock-read-condvar rwlock) #t)))
+            (macro-mutex-unlock! mutex)
+            #t)
+          (begin
+            (macro-mutex-unlock! mutex)
+            #f)))))
+
+(define-prim (rwlock-read-lock!
+              rwlock
+              #!optional
+              (absrel-timeout (macro-absent-obj)))
+  (macro-force-vars (rwlock absrel-timeout)
+    (macro-check-rwlock
+     rwlock
+     1
+     (rwlock-read-lock! rwlock absrel-timeout)
+     (cond ((or (##eq? absrel-timeout (macro-absent-obj))
+                (##not absrel-timeout))
+            (##rwlock-lock! rwlock #t #f))
+           ((macro-absrel-time? absrel-timeout)
+            (##rwlock-lock!
+             rwlock
+             (##absrel-timeout->timeout absrel-timeout)
+             #f))
+           (else
+            (##fail-check-absrel-time-or-false
+             2
+             rwlock-read-lock!
+             rwlock
+             absrel-timeout))))))
+
+(define-prim (rwlock-write-lock!
+              rwlock
+              #!optional
+              (absrel-timeout (macro-absent-obj)))
+  (macro-force-vars (rwlock absrel-timeout)
+    (macro-check-rwlock
+     rwlock
+     1
+     (rwlock-write-lock! rwlock absrel-timeout)
+     (cond ((or (##eq? absrel-timeout (macro-absent-obj))
+                (##not absrel-timeout))
+            (##rwlock-lock! rwlock #t #t))
+           ((macro-absrel-time? absrel-timeout)
+            (##rwlock-lock!
+             rwlock
+             (##absrel-timeout->timeout absrel-timeout)
+             #t))
+           (else
+            (##fail-check-absrel-time-or-false
+             2
+             rwlock-write-lock!
+             rwlock
+             absrel-timeout))))))
+
+(define-prim (rwlock-read-unlock! rwlock)
+  (macro-force-vars (rwlock)
+    (macro-check-rwlock rwlock 1 (rwlock-read-unlock! rwlock)
+      (if (##rwlock-unlock! rwlock #f)
+          (##void)
+          (##raise-error-exception
+           "rwlock is not locked for reading"
+           (##list rwlock))))))
+
+(define-prim (rwlock-write-unlock! rwlock)
+  (macro-force-vars (rwlock)
+    (macro-check-rwlock rwlock 1 (rwlock-write-unlock! rwlock)
+      (if (##rwlock-unlock! rwlock #t)
+          (##void)
+          (##raise-error-exception
+           "rwlock is not locked for writing"
+           (##list rwlock))))))
+
 ;;; User accessible primitives for thread groups.
 
 (define-prim (thread-group? obj)
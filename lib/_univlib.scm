@@ -826,6 +826,7 @@ def @os_device_from_basic_console@():
 (define ##os-exe-extension-string-saved "")
 
 (define (##get-parallelism-level) 1)
+(define (##get-parallelism-max) 0)
 (define (##cpu-count) 1)
 (define (##cpu-cycle-count-start) 0)
 (define (##cpu-cycle-count-end)   0)
@@ -3797,6 +3798,23 @@ def @os_device_stream_seek@(dev_condvar_scm, pos_scm, whence_scm):
     (println "unimplemented ##os-device-stream-seek called")
     -5555)))
 
+(define-prim (##os-device-stream-copy rdev-condvar wdev-condvar len)
+  ##err-code-unimplemented) ;; host devices have no direct transfer
+
+(define-prim (##os-device-stream-mmap dev)
+  ##err-code-unimplemented) ;; host files are not mapped
+
+(define-prim (##os-device-stream-mmap-length dev)
+  #f)
+
+(define-prim (##os-device-stream-mmap-window dev start end tags)
+  ##err-code-unimplemented)
+
+(define-prim (##os-mmap-window-length window) 0)
+(define-prim (##os-mmap-window-ref window i) 0)
+(define-prim (##os-mmap-window-index window byte start end) #f)
+(define-prim (##os-mmap-window-copy! window start end u8vect at) (##void))
+
 (define-prim (##os-device-stream-width dev-condvar)
   (cond-expand
 
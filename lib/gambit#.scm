@@ -519,6 +519,7 @@ make-f64vector
 make-mutex
 make-random-source
 make-root-thread
+make-rwlock
 make-s16vector
 make-s32vector
 make-s64vector
@@ -532,6 +533,11 @@ make-u32vector
 make-u64vector
 make-u8vector
 make-will
+mmap-window->u8vector
+mmap-window-index
+mmap-window-length
+mmap-window-ref
+mmap-window?
 module-not-found-exception-arguments
 module-not-found-exception-procedure
 module-not-found-exception?
@@ -626,7 +632,9 @@ permission-denied-exception-arguments
 permission-denied-exception-procedure
 permission-denied-exception?
 poll-point
+port-copy!
 port-io-exception-handler-set!
+port-mmap-window
 port-settings-set!
 pp
 pretty-print
@@ -715,6 +723,14 @@ rpc-remote-error-exception-arguments
 rpc-remote-error-exception-message
 rpc-remote-error-exception-procedure
 rpc-remote-error-exception?
+rwlock-name
+rwlock-read-lock!
+rwlock-read-unlock!
+rwlock-specific
+rwlock-specific-set!
+rwlock-write-lock!
+rwlock-write-unlock!
+rwlock?
 s16vector
 s16vector->list
 s16vector-append
@@ -1023,6 +1039,7 @@ thread-priority-boost-set!
 thread-quantum
 thread-quantum-set!
 thread-receive
+thread-receive-all
 thread-resume!
 thread-send
 thread-sleep!
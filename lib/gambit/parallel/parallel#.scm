@@ -0,0 +1,20 @@
+;;;============================================================================
+
+;;; File: "parallel#.scm"
+
+;;; Copyright (c) 2026 by Marc Feeley, All Rights Reserved.
+
+;;;============================================================================
+
+;;; Parallel operations on vectors and index ranges.
+
+(##namespace ("gambit/parallel#"
+
+parallel-for
+parallel-vector-map
+parallel-reduce
+parallel-sort!
+
+))
+
+;;;============================================================================
@@ -0,0 +1,238 @@
+;;;============================================================================
+
+;;; File: "parallel.scm"
+
+;;; Copyright (c) 2026 by Marc Feeley, All Rights Reserved.
+
+;;;============================================================================
+
+;;; Parallel operations on vectors and index ranges.
+
+(##supply-module gambit/parallel)
+
+(##namespace ("gambit/parallel#"))        ;; in gambit/parallel#
+(##include "~~lib/gambit#.scm")           ;; for define, declare, etc
+(##include "~~lib/_gambit#.scm")          ;; for macro-check-procedure,
+                                          ;; macro-absent-obj, etc
+
+(##include "parallel#.scm")
+
+(declare (extended-bindings)) ;; ##fx+ is bound to fixnum addition, etc
+(declare (block))             ;; claim no global is assigned
+
+;;;============================================================================
+
+(##demand-module srfi/132) ;; need vector-stable-sort! and vector-merge!
+(##include "~~lib/srfi/132/132#.scm")
+
+;;;----------------------------------------------------------------------------
+
+;; The index range [start,end) is divided into chunks of grain
+;; consecutive indices and each chunk is processed by a separate
+;; thread.  The threads are added to the run queues of idle
+;; processors when there are some, and the other processors steal
+;; them from the run queue where they were added.  By default there
+;; are a few chunks per processor so that processors that finish
+;; early can take on more work.  A grain of 0 selects the default.
+
+(define chunks-per-processor 4)
+
+(define (chunk-grain start end grain)
+  (if (##eq? grain 0)
+      (let ((n (##fx- end start))
+            (k (##fx* chunks-per-processor
+                      (##current-vm-processor-count))))
+        (##fxmax 1 (##fxquotient (##fx+ n (##fx- k 1)) k)))
+      grain))
+
+(define (chunks start end grain)
+  (let loop ((lo start) (rev-chunks '()))
+    (if (##fx< lo end)
+        (let ((hi (##fxmin end (##fx+ lo grain))))
+          (loop hi (##cons (##cons lo hi) rev-chunks)))
+        (##reverse rev-chunks))))
+
+(define (join thread)
+  (with-exception-catcher
+   (lambda (e)
+     (raise (if (uncaught-exception? e)
+                (uncaught-exception-reason e)
+                e)))
+   (lambda ()
+     (thread-join! thread))))
+
+;; Calls (proc lo hi) on each chunk and returns the list of results in
+;; the order of the chunks.  The first chunk is processed by the
+;; current thread while the other chunks are processed in parallel.
+
+(define (run-chunks proc start end grain)
+  (let ((lst (chunks start end (chunk-grain start end grain))))
+    (if (##null? lst)
+        '()
+        (let* ((threads
+                (##map (lambda (chunk)
+                         (thread-start!
+                          (make-thread
+                           (lambda () (proc (##car chunk) (##cdr chunk))))))
+                       (##cdr lst)))
+               (first
+                (proc (##car (##car lst)) (##cdr (##car lst)))))
+          (##cons first (##map join threads))))))
+
+;;;----------------------------------------------------------------------------
+
+(define (parallel-for start end proc #!optional (grain 0))
+  (macro-check-index
+   start
+   1
+   (parallel-for start end proc grain)
+   (macro-check-index
+    end
+    2
+    (parallel-for start end proc grain)
+    (macro-check-procedure
+     proc
+     3
+     (parallel-for start end proc grain)
+     (macro-check-index
+      grain
+      4
+      (parallel-for start end proc grain)
+      (begin
+        (run-chunks
+         (lambda (lo hi)
+           (let loop ((i lo))
+             (if (##fx< i hi)
+                 (begin
+                   (proc i)
+                   (loop (##fx+ i 1))))))
+         start
+         end
+         grain)
+        (##void)))))))
+
+(define (parallel-vector-map proc vect #!optional (grain 0))
+  (macro-check-procedure
+   proc
+   1
+   (parallel-vector-map proc vect grain)
+   (macro-check-vector
+    vect
+    2
+    (parallel-vector-map proc vect grain)
+    (macro-check-index
+     grain
+     3
+     (parallel-vector-map proc vect grain)
+     (let* ((len (##vector-length vect))
+            (result (##make-vector len 0)))
+       (run-chunks
+        (lambda (lo hi)
+          (let loop ((i lo))
+            (if (##fx< i hi)
+                (begin
+                  (##vector-set! result i (proc (##vector-ref vect i)))
+                  (loop (##fx+ i 1))))))
+        0
+        len
+        grain)
+       result)))))
+
+;; The procedure f must be associative and identity must be an
+;; identity element of f, because each chunk is folded separately
+;; starting from identity before the results of the chunks are
+;; combined from left to right.
+
+(define (parallel-reduce f identity vect #!optional (grain 0))
+  (macro-check-procedure
+   f
+   1
+   (parallel-reduce f identity vect grain)
+   (macro-check-vector
+    vect
+    3
+    (parallel-reduce f identity vect grain)
+    (macro-check-index
+     grain
+     4
+     (parallel-reduce f identity vect grain)
+     (let loop ((results
+                 (run-chunks
+                  (lambda (lo hi)
+                    (let loop ((i lo) (acc identity))
+                      (if (##fx< i hi)
+                          (loop (##fx+ i 1) (f acc (##vector-ref vect i)))
+                          acc)))
+                  0
+                  (##vector-length vect)
+                  grain))
+                (acc identity))
+       (if (##pair? results)
+           (loop (##cdr results) (f acc (##car results)))
+           acc))))))
+
+;; The vector is sorted by sorting each chunk in parallel with the
+;; stable merge sort of SRFI 132, and then merging pairs of adjacent
+;; sorted runs in parallel, alternating between the vector and a
+;; temporary vector of the same length, until a single run remains.
+
+(define (parallel-sort! < vect #!optional (grain 0))
+  (macro-check-procedure
+   <
+   1
+   (parallel-sort! < vect grain)
+   (macro-check-vector
+    vect
+    2
+    (parallel-sort! < vect grain)
+    (macro-check-index
+     grain
+     3
+     (parallel-sort! < vect grain)
+     (let* ((len (##vector-length vect))
+            (temp (##make-vector len 0))
+            (runs (run-chunks
+                   (lambda (lo hi)
+                     (vector-stable-sort! < vect lo hi temp)
+                     (##cons lo hi))
+                   0
+                   len
+                   grain)))
+
+       (define (merge-pairs runs)
+         (let loop ((runs runs) (rev-pairs '()))
+           (cond ((##null? runs)
+                  (##reverse rev-pairs))
+                 ((##null? (##cdr runs))
+                  (loop '() (##cons (##list (##car runs)) rev-pairs)))
+                 (else
+                  (loop (##cddr runs)
+                        (##cons (##list (##car runs) (##cadr runs))
+                                rev-pairs))))))
+
+       (define (merge-run pair src dst)
+         (if (##null? (##cdr pair))
+             (let ((run (##car pair)))
+               (subvector-move! src (##car run) (##cdr run) dst (##car run))
+               run)
+             (let ((run1 (##car pair))
+                   (run2 (##cadr pair)))
+               (vector-merge! < dst src src (##car run1)
+                              (##car run1) (##cdr run1)
+                              (##car run2) (##cdr run2))
+               (##cons (##car run1) (##cdr run2)))))
+
+       (let loop ((runs runs) (src vect) (dst temp))
+         (if (and (##pair? runs) (##pair? (##cdr runs)))
+             (let ((pairs (##list->vector (merge-pairs runs))))
+               (loop (##vector->list
+                      (parallel-vector-map
+                       (lambda (pair) (merge-run pair src dst))
+                       pairs
+                       1))
+                     dst
+                     src))
+             (if (##not (##eq? src vect))
+                 (subvector-move! src 0 len vect 0)))))))))
+
+;;;============================================================================
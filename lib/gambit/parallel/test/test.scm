@@ -0,0 +1,77 @@
+;;;============================================================================
+
+;;; File: "test.scm"
+
+;;; Copyright (c) 2026 by Marc Feeley, All Rights Reserved.
+
+;;;============================================================================
+
+;;; Parallel operations on vectors and index ranges.
+
+(import (gambit parallel))
+(import (_test))
+
+;;;============================================================================
+
+(define (iota-vector n)
+  (let ((v (make-vector n)))
+    (let loop ((i 0))
+      (if (< i n)
+          (begin
+            (vector-set! v i i)
+            (loop (+ i 1)))
+          v))))
+
+(define (scrambled-vector n)
+  (let ((v (make-vector n)))
+    (let loop ((i 0))
+      (if (< i n)
+          (begin
+            (vector-set! v i (modulo (* i 7919) n))
+            (loop (+ i 1)))
+          v))))
+
+(test-equal '#() (parallel-vector-map - '#()))
+(test-equal '#(0 -1 -2 -3 -4) (parallel-vector-map - (iota-vector 5)))
+(test-equal '#(0 -1 -2 -3 -4) (parallel-vector-map - (iota-vector 5) 2))
+(test-equal (vector-map square (iota-vector 1000))
+            (parallel-vector-map square (iota-vector 1000) 7))
+
+(let ((v (make-vector 100 #f)))
+  (parallel-for 10 90 (lambda (i) (vector-set! v i (* 2 i))) 3)
+  (test-equal #f (vector-ref v 9))
+  (test-equal 20 (vector-ref v 10))
+  (test-equal 178 (vector-ref v 89))
+  (test-equal #f (vector-ref v 90)))
+
+(test-equal 0 (parallel-reduce + 0 '#()))
+(test-equal 499500 (parallel-reduce + 0 (iota-vector 1000)))
+(test-equal 499500 (parallel-reduce + 0 (iota-vector 1000) 1))
+(test-equal '(0 1 2 3 4)
+            (parallel-reduce append '() (vector-map list (iota-vector 5)) 2))
+
+(let ((v (scrambled-vector 1000)))
+  (parallel-sort! < v 10)
+  (test-equal (iota-vector 1000) v))
+
+(let ((v (scrambled-vector 1000)))
+  (parallel-sort! < v)
+  (test-equal (iota-vector 1000) v))
+
+(let ((v (vector '(1 . a) '(0 . b) '(1 . c) '(0 . d) '(1 . e))))
+  (parallel-sort! (lambda (x y) (< (car x) (car y))) v 1)
+  (test-equal '#((0 . b) (0 . d) (1 . a) (1 . c) (1 . e)) v))
+
+(test-error-tail
+ type-exception?
+ (parallel-vector-map 'foo '#()))
+
+(test-error-tail
+ type-exception?
+ (parallel-sort! < '(1 2 3)))
+
+(test-error-tail
+ range-exception?
+ (parallel-for 0 10 (lambda (i) i) -1))
+
+;;;============================================================================
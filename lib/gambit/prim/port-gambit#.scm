@@ -33,6 +33,11 @@ input-port-readtable
 input-port-readtable-set!
 input-port-timeout-set!
 (make-tls-context unimplemented#make-tls-context)
+mmap-window->u8vector
+mmap-window-index
+mmap-window-length
+mmap-window-ref
+mmap-window?
 object->string
 object->u8vector
 open-directory
@@ -65,7 +70,9 @@ output-port-readtable
 output-port-readtable-set!
 output-port-timeout-set!
 output-port-width
+port-copy!
 port-io-exception-handler-set!
+port-mmap-window
 port-settings-set!
 (pp unimplemented#pp)
 pretty-print
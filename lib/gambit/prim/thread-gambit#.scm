@@ -35,6 +35,7 @@ mailbox-receive-timeout-exception?
 make-condition-variable
 make-mutex
 make-root-thread
+make-rwlock
 make-thread
 make-thread-group
 mutex-lock!
@@ -46,6 +47,14 @@ mutex-unlock!
 mutex?
 processor-id
 processor?
+rwlock-name
+rwlock-read-lock!
+rwlock-read-unlock!
+rwlock-specific
+rwlock-specific-set!
+rwlock-write-lock!
+rwlock-write-unlock!
+rwlock?
 started-thread-exception-arguments
 started-thread-exception-procedure
 started-thread-exception?
@@ -79,6 +88,7 @@ thread-priority-boost-set!
 thread-quantum
 thread-quantum-set!
 thread-receive
+thread-receive-all
 thread-resume!
 thread-send
 thread-sleep!
@@ -41,12 +41,19 @@ int debug_settings;)
         "The -: flag sets options for the Gambit runtime system. OPTION is one of:\n"
         "  min-heap=SIZE      set minimum heap size, shorthand: mSIZE\n"
         "  max-heap=SIZE      set maximum heap size, shorthand: hSIZE\n"
+        "  max-heap-soft=SIZE set soft maximum heap size, GC is more frequent near it\n"
         "                     the heap SIZE may end with G, M or K (default)\n"
         "  live-ratio=RATIO   set heap live ratio after GC in percent, shorthand: lRATIO\n"
+        "  gc-defer-still-free\n"
+        "                     free unreachable still objects in batches after GC\n"
+        "  gc-huge-pages      allocate the heap in memory backed by huge pages\n"
+        "  io-uring           read regular files with io_uring when available\n"
 #ifndef ___SINGLE_THREADED_VMS
         "  parallelism=LEVEL  set parallelism level, shorthand: pLEVEL, where LEVEL can\n"
         "                     be positive (nb of processors), negative (nb of unused\n"
         "                     processors), or end with % (ratio of available processors)\n"
+        "                     LEVEL can also be MIN-MAX or auto (1-nb of processors)\n"
+        "                     to adjust the nb of processors to the load, up to MAX\n"
 #endif
         "  gambit             set Gambit mode, shorthand: S (default mode)\n"
         "  r4rs | ... | r7rs  set RnRS mode (R7RS mode shorthand: s)\n"
@@ -463,8 +470,12 @@ ___mod_or_lnk (*linker)();)
   ___UCS_2STRING repl_server_addr;
   unsigned long min_heap_len;
   unsigned long max_heap_len;
+  unsigned long max_heap_soft_len;
   int live_percent;
   int parallelism_level;
+  int parallelism_max;
+  int gc_settings;
+  int io_uring;
   int standard_level;
   int debug_settings;
   int io_settings[___IO_SETTINGS_LAST+1];
@@ -490,7 +501,11 @@ ___mod_or_lnk (*linker)();)
   repl_server_addr = 0;
   min_heap_len = 0;
   max_heap_len = 0;
+  max_heap_soft_len = 0;
   live_percent = 0;
+  gc_settings = 0;
+  io_uring = 0;
+  parallelism_max = 0;
 #ifdef ___SINGLE_THREADED_VMS
   parallelism_level = 1;
 #else
@@ -637,6 +652,11 @@ ___mod_or_lnk (*linker)();)
                   arg++;
                   if (starts_with (s, "min-heap"))
                     goto mhlp_options;
+                  else if (starts_with (s, "max-heap-soft"))
+                    {
+                      s += 9; /* point to the 's' */
+                      goto mhlp_options;
+                    }
                   else if (starts_with (s, "max-heap"))
                     {
                       s += 4; /* point to the 'h' */
@@ -752,6 +772,25 @@ ___mod_or_lnk (*linker)();)
                 }
               else if (option_equal (s, "debug"))
                 goto debug_option;
+              else if (option_equal (s, "gc-defer-still-free"))
+                {
+                  gc_settings =
+                    (gc_settings & ~___GC_SETTINGS_DEFER_STILL_FREE_MASK)
+                    | (1 << ___GC_SETTINGS_DEFER_STILL_FREE_SHIFT);
+                  continue;
+                }
+              else if (option_equal (s, "gc-huge-pages"))
+                {
+                  gc_settings =
+                    (gc_settings & ~___GC_SETTINGS_HUGE_PAGES_MASK)
+                    | (1 << ___GC_SETTINGS_HUGE_PAGES_SHIFT);
+                  continue;
+                }
+              else if (option_equal (s, "io-uring"))
+                {
+                  io_uring = 1;
+                  continue;
+                }
               else if (option_equal (s, "r4rs"))
                 goto r4rs_option;
               else if (option_equal (s, "r5rs"))
@@ -768,14 +807,29 @@ ___mod_or_lnk (*linker)();)
 
           switch (*s)
             {
+            case 'p':
+              if (*arg == '=') /* shorthand can also be p=LEVEL */
+                arg++;
+              goto mhlp_options;
             case 'm':
             case 'h':
             case 'l':
-            case 'p':
             mhlp_options:
               {
+                ___UCS_2STRING start = arg;
                 unsigned long argval = 0;
                 int neg = *arg == '-';
+                if (*s == 'p' && starts_with (arg, "auto"))
+                  {
+#ifndef ___SINGLE_THREADED_VMS
+                    int count = ___cpu_count (-1);
+                    if (count < 1) count = 1;
+                    parallelism_level = 1;
+                    parallelism_max = count;
+#endif
+                    arg += 4;
+                    break;
+                  }
                 if (neg && *s == 'p' && is_digit (arg[1]))
                   arg++;
                 while (is_digit (*arg))
@@ -791,7 +845,7 @@ ___mod_or_lnk (*linker)();)
                     argval = argval*10 + n;
                     arg++;
                   }
-                if (arg == s+1)
+                if (arg == start) /* no LEVEL, even after p= */
                   {
                     e = usage_err (debug_settings);
                     goto after_setup;
@@ -800,6 +854,7 @@ ___mod_or_lnk (*linker)();)
                   {
                   case 'm':
                   case 'h':
+                  case 's':
                     {
                       int shift = 10;
                       unsigned long orig = argval;
@@ -825,8 +880,10 @@ ___mod_or_lnk (*linker)();)
                         }
                       if (*s == 'm')
                         min_heap_len = argval;
-                      else
+                      else if (*s == 'h')
                         max_heap_len = argval;
+                      else
+                        max_heap_soft_len = argval;
                       break;
                     }
                   case 'l':
@@ -846,12 +903,38 @@ ___mod_or_lnk (*linker)();)
                           parallelism_level = count - parallelism_level;
                         if (parallelism_level < 1)
                           parallelism_level = 1;
+                        parallelism_max = 0;
 #endif
                         arg++;
                       }
+                    else if (*arg == '-' && !neg && is_digit (arg[1]))
+                      {
+                        unsigned long maxval = 0;
+                        arg++;
+                        while (is_digit (*arg))
+                          {
+                            if (maxval < 1000000)
+                              maxval = maxval*10 + (*arg - '0');
+                            arg++;
+                          }
+                        if (argval < 1)
+                          argval = 1;
+                        if (maxval < argval || maxval > 1000000)
+                          {
+                            e = usage_err (debug_settings);
+                            goto after_setup;
+                          }
+#ifndef ___SINGLE_THREADED_VMS
+                        parallelism_level = argval;
+                        parallelism_max = maxval;
+#endif
+                      }
 #ifndef ___SINGLE_THREADED_VMS
                     else
-                      parallelism_level = neg ? -argval : argval;
+                      {
+                        parallelism_level = neg ? -argval : argval;
+                        parallelism_max = 0;
+                      }
 #endif
                   }
                 break;
@@ -1321,8 +1404,12 @@ ___mod_or_lnk (*linker)();)
   setup_params.argv                = current_argv;
   setup_params.min_heap            = min_heap_len;
   setup_params.max_heap            = max_heap_len;
+  setup_params.max_heap_soft       = max_heap_soft_len;
   setup_params.live_percent        = live_percent;
   setup_params.parallelism_level   = parallelism_level;
+  setup_params.parallelism_max     = parallelism_max;
+  setup_params.gc_settings         = gc_settings;
+  setup_params.io_uring            = io_uring;
   setup_params.standard_level      = standard_level;
   setup_params.debug_settings      = debug_settings;
   for (settings_index=0; settings_index<=___IO_SETTINGS_LAST; settings_index++)
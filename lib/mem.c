@@ -291,7 +291,6 @@
 #define alloc_heap_chunk_limit  ___PSTATE_MEM(alloc_heap_chunk_limit_)
 
 #ifndef ___SINGLE_THREADED_VMS
-#define heap_chunks_to_scan_lock ___PSTATE_MEM(heap_chunks_to_scan_lock_)
 #endif
 
 #define heap_chunks_to_scan     ___PSTATE_MEM(heap_chunks_to_scan_)
@@ -300,6 +299,25 @@
 #define scan_ptr                ___PSTATE_MEM(scan_ptr_)
 #define still_objs_to_scan      ___PSTATE_MEM(still_objs_to_scan_)
 #define still_objs              ___PSTATE_MEM(still_objs_)
+#define still_objs_to_free      ___PSTATE_MEM(still_objs_to_free_)
+#define still_cache             ___PSTATE_MEM(still_cache_)
+#define words_still_cache       ___PSTATE_MEM(words_still_cache_)
+#define gc_words_scanned        ___PSTATE_MEM(gc_words_scanned_)
+#define gc_chunks_stolen        ___PSTATE_MEM(gc_chunks_stolen_)
+#define gc_wills                ___PSTATE_MEM(gc_wills_)
+#define gc_wills_executable     ___PSTATE_MEM(gc_wills_executable_)
+#define gc_words_still_freed    ___PSTATE_MEM(gc_words_still_freed_)
+#define alloc_sample_countdown  ___PSTATE_MEM(alloc_sample_countdown_)
+#define alloc_sample_base       ___PSTATE_MEM(alloc_sample_base_)
+#define alloc_sample_heap_limit ___PSTATE_MEM(alloc_sample_heap_limit_)
+#define alloc_sample_armed      ___PSTATE_MEM(alloc_sample_armed_)
+#define gc_census_count         ___PSTATE_MEM(gc_census_count_)
+#define gc_census_words         ___PSTATE_MEM(gc_census_words_)
+#define gc_census_type          ___PSTATE_MEM(gc_census_type_)
+#define gc_census_type_count    ___PSTATE_MEM(gc_census_type_count_)
+#define gc_census_type_words    ___PSTATE_MEM(gc_census_type_words_)
+#define gc_census_other_count   ___PSTATE_MEM(gc_census_other_count_)
+#define gc_census_other_words   ___PSTATE_MEM(gc_census_other_words_)
 #define words_still_objs        ___PSTATE_MEM(words_still_objs_)
 #define words_still_objs_deferred ___PSTATE_MEM(words_still_objs_deferred_)
 #define bytes_allocated_minus_occupied ___PSTATE_MEM(bytes_allocated_minus_occupied_)
@@ -353,6 +371,21 @@
 #define latest_gc_movable       ___VMSTATE_MEM(latest_gc_movable_)
 #define latest_gc_still         ___VMSTATE_MEM(latest_gc_still_)
 
+#define gc_phase_time           ___VMSTATE_MEM(gc_phase_time_)
+#define latest_gc_phase_time    ___VMSTATE_MEM(latest_gc_phase_time_)
+#define gc_pause_hist           ___VMSTATE_MEM(gc_pause_hist_)
+#define gc_max_pause            ___VMSTATE_MEM(gc_max_pause_)
+#define gc_bytes_copied         ___VMSTATE_MEM(gc_bytes_copied_)
+#define gc_bytes_still_freed    ___VMSTATE_MEM(gc_bytes_still_freed_)
+#define latest_gc_bytes_still_freed ___VMSTATE_MEM(latest_gc_bytes_still_freed_)
+
+#define alloc_sample_interval   ___VMSTATE_MEM(alloc_sample_interval_)
+#define alloc_sample_ra         ___VMSTATE_MEM(alloc_sample_ra_)
+#define alloc_sample_subtype    ___VMSTATE_MEM(alloc_sample_subtype_)
+#define alloc_sample_count      ___VMSTATE_MEM(alloc_sample_count_)
+#define alloc_samples_lost      ___VMSTATE_MEM(alloc_samples_lost_)
+#define gc_census               ___VMSTATE_MEM(gc_census_)
+#define msection_regions        ___VMSTATE_MEM(msection_regions_)
 #define custom_msection_alloc   ___VMSTATE_MEM(custom_msection_alloc_)
 
 /* words occupied by this processor by movable objects */
@@ -888,7 +921,135 @@ void *ptr;)
 
 
 /*
- * 'adjust_msections (msp, n)' contracts or expands the msections
+ * Msections are allocated in regions of memory pages obtained from
+ * the operating system with ___alloc_mem_pages, so that the memory of
+ * the msections freed when the heap shrinks is really returned to the
+ * operating system (the C heap will often keep it).  Each region is
+ * aligned on a huge page boundary and contains up to
+ * ___MSECTION_REGION_SLOTS msections (the region header and any unused
+ * space at the end of the region are the only overhead).  The pages
+ * of a free slot are decommitted and a region is unmapped when none
+ * of its msections are used.  When the -:gc-huge-pages runtime option
+ * is used the operating system is asked to back the regions with huge
+ * pages, which reduces the TLB misses when a large heap is traversed
+ * by the GC and the program.  When a region can't be allocated (or the
+ * operating system doesn't support it), the msection is allocated in
+ * the C heap.
+ */
+
+typedef struct msection_region_struct
+  {
+    struct msection_region_struct *next; /* next region in list */
+    ___SIZE_TS bytes;                    /* size of region in bytes */
+    int nb_used;                         /* number of slots in use */
+    char used[___MSECTION_REGION_SLOTS]; /* which slots are in use */
+  } msection_region;
+
+#define MSECTION_SLOT_BYTES \
+((___sizeof_msection(___MSECTION_SIZE) + 63) & ~___CAST(___SIZE_T,63))
+
+#define MSECTION_REGION_HEADER_BYTES \
+((sizeof (msection_region) + 63) & ~___CAST(___SIZE_T,63))
+
+#define MSECTION_REGION_BYTES \
+((MSECTION_REGION_HEADER_BYTES + \
+  ___MSECTION_REGION_SLOTS * MSECTION_SLOT_BYTES + \
+  ___HUGE_PAGE_SIZE - 1) & ~___CAST(___SIZE_T,___HUGE_PAGE_SIZE - 1))
+
+#define MSECTION_REGION_SLOT(r,i) \
+___CAST(___msection*, \
+        ___CAST(char*,r) + MSECTION_REGION_HEADER_BYTES + \
+        (i) * MSECTION_SLOT_BYTES)
+
+
+___HIDDEN ___msection *alloc_msection_mem
+   ___P((___virtual_machine_state ___vms),
+        (___vms)
+___virtual_machine_state ___vms;)
+{
+  msection_region *r =
+    ___CAST(msection_region*,___vms->mem.msection_regions_);
+  int i;
+
+  while (r != 0 && r->nb_used == ___MSECTION_REGION_SLOTS)
+    r = r->next;
+
+  if (r == 0 &&
+      (r = ___CAST(msection_region*,
+                   ___alloc_mem_pages
+                     (MSECTION_REGION_BYTES,
+                      ___HUGE_PAGE_SIZE,
+                      ___GC_SETTINGS_HUGE_PAGES
+                        (___GSTATE->setup_params.gc_settings))))
+      != 0)
+    {
+      r->next = ___CAST(msection_region*,___vms->mem.msection_regions_);
+      r->bytes = MSECTION_REGION_BYTES;
+      r->nb_used = 0;
+      for (i=0; i<___MSECTION_REGION_SLOTS; i++)
+        r->used[i] = 0;
+      ___vms->mem.msection_regions_ = r;
+    }
+
+  if (r != 0)
+    {
+      for (i=0; r->used[i]; i++) ;
+      r->used[i] = 1;
+      r->nb_used++;
+      return MSECTION_REGION_SLOT(r,i);
+    }
+
+  return ___CAST(___msection*,
+                 alloc_mem_aligned_heap
+                   (___WORDS(___sizeof_msection(___MSECTION_SIZE)),
+                    1,
+                    0));
+}
+
+
+___HIDDEN void free_msection_mem
+   ___P((___virtual_machine_state ___vms,
+         ___msection *s),
+        (___vms,
+         s)
+___virtual_machine_state ___vms;
+___msection *s;)
+{
+  msection_region **rp =
+    ___CAST(msection_region**,&___vms->mem.msection_regions_);
+  msection_region *r;
+
+  while ((r = *rp) != 0)
+    {
+      if (___CAST(char*,s) >= ___CAST(char*,r) &&
+          ___CAST(char*,s) < ___CAST(char*,r) + r->bytes)
+        {
+          int i = (___CAST(char*,s) -
+                   ___CAST(char*,MSECTION_REGION_SLOT(r,0))) /
+                  MSECTION_SLOT_BYTES;
+
+          r->used[i] = 0;
+
+          if (--r->nb_used == 0)
+            {
+              *rp = r->next;
+              ___free_mem_pages (r, r->bytes);
+            }
+          else
+            ___decommit_mem_pages (s, MSECTION_SLOT_BYTES);
+
+          return;
+        }
+
+      rp = &r->next;
+    }
+
+  free_mem_aligned_heap (s);
+}
+
+
+/*
+ * 'adjust_msections (___vms, msp, n)' contracts or expands the msections
  * pointed to by 'msp' so that it contains 'n' sections.  When the
  * msections is contracted, the last sections allocated (i.e. those at
  * the end of the doubly-linked list of sections) will be reclaimed.
@@ -901,10 +1062,13 @@ void *ptr;)
  */
 
 ___HIDDEN void adjust_msections
-   ___P((___msections **msp,
+   ___P((___virtual_machine_state ___vms,
+         ___msections **msp,
          int n),
-        (msp,
+        (___vms,
+         msp,
          n)
+___virtual_machine_state ___vms;
 ___msections **msp;
 int n;)
 {
@@ -986,7 +1150,7 @@ int n;)
               ms->sections[j]->pos = j;
             }
 
-          free_mem_aligned_heap (s);
+          free_msection_mem (___vms, s);
 
           ns--;
         }
@@ -1009,11 +1173,7 @@ int n;)
 
       while (ns < n)
         {
-          ___msection *s = ___CAST(___msection*,
-                                   alloc_mem_aligned_heap
-                                     (___WORDS(___sizeof_msection(___MSECTION_SIZE)),
-                                      1,
-                                      0));
+          ___msection *s = alloc_msection_mem (___vms);
 
           if (s == 0)
             return;
@@ -1058,13 +1218,16 @@ int n;)
 
 
 /*
- * 'free_msections (msp)' releases all memory associated with the
- * msections pointed to by 'msp'.
+ * 'free_msections (___vms, msp)' releases all memory associated with
+ * the msections pointed to by 'msp'.
  */
 
 ___HIDDEN void free_msections
-   ___P((___msections **msp),
-        (msp)
+   ___P((___virtual_machine_state ___vms,
+         ___msections **msp),
+        (___vms,
+         msp)
+___virtual_machine_state ___vms;
 ___msections **msp;)
 {
   ___msections *ms = *msp;
@@ -1074,7 +1237,7 @@ ___msections **msp;)
       int i;
 
       for (i=ms->nb_sections-1; i>=0; i--)
-        free_mem_aligned_heap (ms->sections[i]);
+        free_msection_mem (___vms, ms->sections[i]);
 
       free_mem_aligned (ms);
 
@@ -1553,6 +1716,339 @@ ___SIZE_TS bytes;)
 }
 
 
+/*
+ * Still objects that are bigger than ___MSECTION_BIGGEST words and
+ * no bigger than the largest size class of the still object block
+ * cache have their size rounded up to the size of their class.  When
+ * such an object is reclaimed, its block is kept in the cache of the
+ * processor that reclaims it, so that it can be reused for a still
+ * object of the same class without going through the C heap (and its
+ * locking) and without fragmenting the C heap.  Each processor has its
+ * own cache so no locking is needed to access it.  The blocks that
+ * remain unused from one GC to the next are returned to the C heap.
+ */
+
+#define still_cache_class_words(c) \
+(___CAST(___SIZE_TS,___STILL_CACHE_MIN_WORDS/2) * ((2+((c)&1)) << ((c)>>1)))
+
+___HIDDEN int still_cache_class
+   ___P((___SIZE_TS words),
+        (words)
+___SIZE_TS words;)
+{
+  int c = 0;
+
+  if (words <= ___MSECTION_BIGGEST ||
+      words > still_cache_class_words(___STILL_CACHE_NB_CLASSES-1))
+    return -1;
+
+  while (still_cache_class_words(c) < words)
+    c++;
+
+  return c;
+}
+
+
+___HIDDEN void *alloc_still_block
+   ___P((___processor_state ___ps,
+         ___SIZE_TS words,
+         int c),
+        (___ps,
+         words,
+         c)
+___processor_state ___ps;
+___SIZE_TS words;
+int c;)
+{
+  if (c >= 0 && still_cache[c] != 0)
+    {
+      ___WORD *base = ___CAST(___WORD*,still_cache[c]);
+      still_cache[c] = base[___STILL_LINK];
+      words_still_cache -= words;
+      return base;
+    }
+
+  /*
+   * Some objects, such as ___sFOREIGN, ___sS64VECTOR, ___sU64VECTOR,
+   * ___sF64VECTOR, ___sFLONUM and ___sBIGNUM, must have a body that
+   * is aligned on a multiple of 8 on some machines.  Here, we force
+   * alignment to a multiple of 8 even if not necessary in all cases
+   * because it is typically more efficient due to a better
+   * utilization of the cache.
+   */
+
+  return alloc_mem_aligned_heap (words,
+                                 8>>___LWS,
+                                 (-___STILL_BODY)&((8>>___LWS)-1));
+}
+
+
+___HIDDEN void free_still_cache
+   ___P((___processor_state ___ps),
+        (___ps)
+___processor_state ___ps;)
+{
+  int c;
+
+  for (c=0; c<___STILL_CACHE_NB_CLASSES; c++)
+    {
+      ___WORD *base = ___CAST(___WORD*,still_cache[c]);
+
+      still_cache[c] = 0;
+
+      while (base != 0)
+        {
+          ___WORD link = base[___STILL_LINK];
+          free_mem_aligned_heap (base);
+          base = ___CAST(___WORD*,link);
+        }
+    }
+
+  words_still_cache = 0;
+}
+
+
+___HIDDEN void release_foreign_still_obj
+   ___P((___WORD *base),
+        (base)
+___WORD *base;)
+{
+  ___WORD head = base[___STILL_BODY-1];
+
+  if (___HD_SUBTYPE(head) == ___sFOREIGN)
+    ___release_foreign
+      (___TAG(base + ___STILL_BODY - ___REFERENCE_TO_BODY, ___tSUBTYPED));
+}
+
+
+___HIDDEN ___BOOL cache_still_block
+   ___P((___processor_state ___ps,
+         ___WORD *base),
+        (___ps,
+         base)
+___processor_state ___ps;
+___WORD *base;)
+{
+  ___SIZE_TS words = base[___STILL_LENGTH];
+  int c = still_cache_class (words);
+
+  if (c >= 0 && words_still_cache + words <= ___STILL_CACHE_MAX_WORDS)
+    {
+      base[___STILL_LINK] = still_cache[c];
+      still_cache[c] = ___CAST(___WORD,base);
+      words_still_cache += words;
+      return 1;
+    }
+
+  return 0;
+}
+
+
+___HIDDEN void release_still_obj
+   ___P((___processor_state ___ps,
+         ___WORD *base),
+        (___ps,
+         base)
+___processor_state ___ps;
+___WORD *base;)
+{
+  release_foreign_still_obj (base);
+
+  if (!cache_still_block (___ps, base))
+    free_mem_aligned_heap (base);
+}
+
+
+/*
+ * 'defer_still_cache (___ps, to_free)' adds the blocks in the still
+ * object block cache of the processor to the list of blocks 'to_free'
+ * and returns the new list.  It is used instead of free_still_cache
+ * when the freeing of still objects is deferred, so that no block is
+ * returned to the C heap during the GC.
+ */
+
+___HIDDEN ___WORD defer_still_cache
+   ___P((___processor_state ___ps,
+         ___WORD to_free),
+        (___ps,
+         to_free)
+___processor_state ___ps;
+___WORD to_free;)
+{
+  int c;
+
+  for (c=0; c<___STILL_CACHE_NB_CLASSES; c++)
+    {
+      ___WORD *base = ___CAST(___WORD*,still_cache[c]);
+
+      still_cache[c] = 0;
+
+      while (base != 0)
+        {
+          ___WORD link = base[___STILL_LINK];
+          base[___STILL_LINK] = to_free;
+          to_free = ___CAST(___WORD,base);
+          base = ___CAST(___WORD*,link);
+        }
+    }
+
+  words_still_cache = 0;
+
+  return to_free;
+}
+
+
+/*
+ * 'free_still_objs_to_free (___ps, n)' returns to the C heap at most
+ * 'n' of the blocks that the GC has left on the processor's
+ * still_objs_to_free list when the freeing of still objects is
+ * deferred (the -:gc-defer-still-free runtime option).  The foreign
+ * objects in these blocks were released by the GC.  It is called by
+ * the processor when it allocates, so that the cost of freeing a long
+ * list of dead still objects is spread over the execution of the
+ * program instead of lengthening the GC pause.  These objects are no
+ * longer counted in the heap occupation, so this only delays returning
+ * their memory to the C heap.
+ */
+
+___HIDDEN void free_still_objs_to_free
+   ___P((___processor_state ___ps,
+         int n),
+        (___ps,
+         n)
+___processor_state ___ps;
+int n;)
+{
+  ___WORD *base = ___CAST(___WORD*,still_objs_to_free);
+
+  while (base != 0 && n-- > 0)
+    {
+      ___WORD link = base[___STILL_LINK];
+      free_mem_aligned_heap (base);
+      base = ___CAST(___WORD*,link);
+    }
+
+  still_objs_to_free = ___CAST(___WORD,base);
+}
+
+
+/*
+ * Allocation sampling.
+ *
+ * When sampling is enabled each processor samples an allocation every
+ * time it has allocated 'alloc_sample_interval' words.  A sample is
+ * attributed to the return address of the topmost continuation frame,
+ * which is in the code that is allocating since the allocation entry
+ * points (the heap-limit handler and the primitives that allocate
+ * still objects) save the return address before calling the memory
+ * manager, and to the subtype of the object allocated.  For movable
+ * objects the heap limit is lowered to the next sampling point (see
+ * prepare_mem_pstate) so that the sampling costs nothing between
+ * samples and nothing at all when it is disabled.
+ */
+
+___HIDDEN ___SCMOBJ allocating_code_ra
+   ___P((___processor_state ___ps),
+        (___ps)
+___processor_state ___ps;)
+{
+  ___WORD *fp = ___ps->fp;
+  ___SCMOBJ ra;
+
+  if (fp == ___ps->stack_break)
+    return ___FAL;
+
+  ra = ___FP_STK(fp,-___FRAME_STACK_RA);
+
+  if (ra == ___GSTATE->internal_return)
+    ra = ___FP_STK(fp,___RETI_RA);
+
+  if (!___TESTTYPE(ra,___tSUBTYPED) ||
+      !___TESTSUBTYPETAG(ra,___sPROCEDURE))
+    return ___FAL; /* frame being constructed by a rest param handler */
+
+  return ra;
+}
+
+
+___HIDDEN void record_alloc_sample
+   ___P((___processor_state ___ps,
+         ___SCMOBJ ra,
+         int subtype,
+         ___SIZE_TS n),
+        (___ps,
+         ra,
+         subtype,
+         n)
+___processor_state ___ps;
+___SCMOBJ ra;
+int subtype;
+___SIZE_TS n;)
+{
+  int i = ((___CAST(___UWORD,ra) >> ___LWS) * 31 + subtype) %
+          ___ALLOC_SAMPLE_TABLE_LENGTH;
+  int probes;
+
+  MISC_MEM_LOCK();
+
+  for (probes=0; probes<___ALLOC_SAMPLE_TABLE_LENGTH; probes++)
+    {
+      if (alloc_sample_count[i] == 0)
+        {
+          alloc_sample_ra[i] = ra;
+          alloc_sample_subtype[i] = subtype;
+        }
+
+      if (alloc_sample_ra[i] == ra && alloc_sample_subtype[i] == subtype)
+        {
+          alloc_sample_count[i] += n;
+          MISC_MEM_UNLOCK();
+          return;
+        }
+
+      i = (i+1) % ___ALLOC_SAMPLE_TABLE_LENGTH;
+    }
+
+  alloc_samples_lost += n; /* table is full */
+
+  MISC_MEM_UNLOCK();
+}
+
+
+___HIDDEN ___BOOL sample_heap_alloc
+   ___P((___processor_state ___ps),
+        (___ps)
+___processor_state ___ps;)
+{
+  /*
+   * Account for the movable objects allocated since the heap limit
+   * was last computed.  When the sampling point is reached, the next
+   * movable object allocated is sampled (its header is the first word
+   * allocated after the heap limit is recomputed).  Returns true when
+   * the heap limit was only reached because of the sampling.
+   */
+
+  ___SIZE_TS words = alloc_heap_ptr - alloc_sample_base;
+
+  if (alloc_sample_armed)
+    {
+      if (words > 0)
+        {
+          record_alloc_sample (___ps,
+                               allocating_code_ra (___ps),
+                               ___HD_SUBTYPE(alloc_sample_base[0]),
+                               1);
+          alloc_sample_armed = 0;
+          alloc_sample_countdown = alloc_sample_interval;
+        }
+    }
+  else if ((alloc_sample_countdown -= words) <= 0)
+    alloc_sample_armed = 1;
+
+  return alloc_heap_ptr <= alloc_sample_heap_limit;
+}
+
+
 ___HIDDEN ___WORD alloc_scmobj_still
    ___P((___processor_state ___ps,
          int subtype,
@@ -1568,7 +2064,16 @@ ___SIZE_TS bytes;)
   ___WORD *base;
   ___WORD *body;
   ___SIZE_TS words = ___STILL_BODY + ___WORDS(bytes);
-  ___SIZE_TS words_including_deferred = words + words_still_objs_deferred;
+  ___SIZE_TS words_including_deferred;
+  int c = still_cache_class (words);
+
+  if (c >= 0)
+    words = still_cache_class_words(c);
+
+  words_including_deferred = words + words_still_objs_deferred;
+
+  if (still_objs_to_free != 0)
+    free_still_objs_to_free (___ps, ___STILL_FREE_BATCH);
 
 #ifdef CALL_GC_FREQUENTLY
   if (--___gc_calls_to_punt < 0) goto invoke_gc;
@@ -1581,19 +2086,7 @@ ___SIZE_TS bytes;)
        * level.
        */
 
-      /*
-       * Some objects, such as ___sFOREIGN, ___sS64VECTOR,
-       * ___sU64VECTOR, ___sF64VECTOR, ___sFLONUM and ___sBIGNUM, must
-       * have a body that is aligned on a multiple of 8 on some
-       * machines.  Here, we force alignment to a multiple of 8 even
-       * if not necessary in all cases because it is typically more
-       * efficient due to a better utilization of the cache.
-       */
-
-      if ((ptr = alloc_mem_aligned_heap (words,
-                                         8>>___LWS,
-                                         (-___STILL_BODY)&((8>>___LWS)-1)))
-          == 0)
+      if ((ptr = alloc_still_block (___ps, words, c)) == 0)
         {
           /*
            * Couldn't allocate the still object (probably the C heap is full).
@@ -1649,14 +2142,10 @@ ___SIZE_TS bytes;)
         }
 
       /*
-       * Allocate the still object.  See comments above for other call
-       * to alloc_mem_aligned_heap.
+       * Allocate the still object.
        */
 
-      if ((ptr = alloc_mem_aligned_heap (words,
-                                         8>>___LWS,
-                                         (-___STILL_BODY)&((8>>___LWS)-1)))
-          == 0)
+      if ((ptr = alloc_still_block (___ps, words, c)) == 0)
         {
           /*
            * Couldn't allocate the still object (probably the C heap is full).
@@ -1689,6 +2178,17 @@ ___SIZE_TS bytes;)
 
   base[___STILL_HEADER] = ___MAKE_HD(bytes, subtype, ___STILL);
 
+  if (alloc_sample_interval != 0 &&
+      !alloc_sample_armed &&
+      (alloc_sample_countdown -= words) <= 0)
+    {
+      ___SIZE_TS n = 1 + (-alloc_sample_countdown) / alloc_sample_interval;
+
+      alloc_sample_countdown += n * alloc_sample_interval;
+
+      record_alloc_sample (___ps, allocating_code_ra (___ps), subtype, n);
+    }
+
   /* Return tagged reference to still object. */
 
 #if ___tPAIR != ___tSUBTYPED
@@ -1933,6 +2433,72 @@ ___SIZE_TS length;)
 }
 
 
+___HIDDEN void resize_symkey_table
+   ___P((unsigned int subtype,
+         int new_len),
+        (subtype,
+         new_len)
+unsigned int subtype;
+int new_len;)
+{
+  ___SCMOBJ tbl = symkey_table (subtype);
+  ___SCMOBJ newtbl = alloc_symkey_table (subtype, new_len);
+  int i;
+
+  if (!___FIXNUMP(newtbl))
+    {
+      for (i=___INT(___VECTORLENGTH(tbl))-1; i>0; i--)
+        {
+          ___SCMOBJ probe = ___VECTORELEM(tbl, i);
+
+          while (probe != ___NUL)
+            {
+              ___SCMOBJ symkey = probe;
+              int j = ___INT(___SYMKEY_HASH_FIELD(symkey))%new_len + 1;
+
+              probe = ___SYMKEY_NEXT_FIELD(symkey);
+              ___SYMKEY_NEXT_FIELD(symkey) = ___VECTORELEM(newtbl, j);
+              ___VECTORELEM(newtbl,j) = symkey;
+            }
+        }
+
+      ___VECTORELEM(newtbl, 0) = ___VECTORELEM(tbl, 0);
+
+      symkey_table_set (subtype, newtbl);
+    }
+}
+
+
+void ___reserve_symkey_table
+   ___P((unsigned int subtype,
+         ___SIZE_TS n),
+        (subtype,
+         n)
+unsigned int subtype;
+___SIZE_TS n;)
+{
+  /*
+   * Grow the table so that 'n' more symbols/keywords can be interned
+   * while keeping an average list length of at most 1.  This is used
+   * at program startup, where the number of symbols and keywords of
+   * the linked modules is known in advance, to avoid the successive
+   * rehashing of the table while the modules' symbols are interned
+   * and to speed up the lookups done later by the program.
+   */
+
+  ___SCMOBJ tbl = symkey_table (subtype);
+  int len = ___INT(___VECTORLENGTH(tbl)) - 1;
+  int new_len = len;
+  ___SIZE_TS count = ___INT(___VECTORELEM(tbl, 0)) + n;
+
+  while (new_len < count)
+    new_len *= 2;
+
+  if (new_len != len)
+    resize_symkey_table (subtype, new_len);
+}
+
+
 void ___intern_symkey
    ___P((___SCMOBJ symkey),
         (symkey)
@@ -1959,32 +2525,7 @@ ___SCMOBJ symkey;)
    */
 
   if (___INT(___VECTORELEM(tbl, 0)) > ___INT(___VECTORLENGTH(tbl)) * 4)
-    {
-      int new_len = (___INT(___VECTORLENGTH(tbl))-1) * 2;
-      ___SCMOBJ newtbl = alloc_symkey_table (subtype, new_len);
-
-      if (!___FIXNUMP(newtbl))
-        {
-          for (i=___INT(___VECTORLENGTH(tbl))-1; i>0; i--)
-            {
-              ___SCMOBJ probe = ___VECTORELEM(tbl, i);
-
-              while (probe != ___NUL)
-                {
-                  ___SCMOBJ symkey = probe;
-                  int j = ___INT(___SYMKEY_HASH_FIELD(symkey))%new_len + 1;
-
-                  probe = ___SYMKEY_NEXT_FIELD(symkey);
-                  ___SYMKEY_NEXT_FIELD(symkey) = ___VECTORELEM(newtbl, j);
-                  ___VECTORELEM(newtbl,j) = symkey;
-                }
-            }
-
-          ___VECTORELEM(newtbl, 0) = ___VECTORELEM(tbl, 0);
-
-          symkey_table_set (subtype, newtbl);
-        }
-    }
+    resize_symkey_table (subtype, (___INT(___VECTORLENGTH(tbl))-1) * 2);
 }
 
 
@@ -3273,9 +3814,10 @@ ___processor_state ___ps;)
 
       ___WORD *new_tail = alloc_heap_chunk_start-1;
 
-#ifndef ___SINGLE_THREADED_VMS
-      ___SPINLOCK_LOCK(heap_chunks_to_scan_lock);
-#endif
+      /*
+       * Only this processor adds chunks to its heap chunk FIFO so no
+       * lock is needed (see pop_heap_chunk_to_scan).
+       */
 
       *heap_chunks_to_scan_tail = ___TAG(new_tail, ___FORW);
 
@@ -3301,13 +3843,60 @@ ___processor_state ___ps;)
       ___SHARED_MEMORY_BARRIER();
 
 #ifndef ___SINGLE_THREADED_VMS
-      ___SPINLOCK_UNLOCK(heap_chunks_to_scan_lock);
       ___CONDVAR_SIGNAL(scan_termination_condvar);
 #endif
     }
 }
 
 
+/*
+ * 'pop_heap_chunk_to_scan (___ps)' removes the oldest chunk from the
+ * heap chunk FIFO of processor '___ps' and returns a pointer to the
+ * link preceding the chunk, or 0 when the FIFO is empty.  Chunks are
+ * only added at the tail by the processor owning the FIFO, but they
+ * are removed at the head both by the owner and by other processors
+ * stealing work, so a compare-and-swap is used to advance the head.
+ * The head only moves forward in tospace during a GC so there is no
+ * ABA problem.
+ */
+
+___HIDDEN ___WORD *pop_heap_chunk_to_scan
+   ___P((___processor_state ___ps),
+        (___ps)
+___processor_state ___ps;)
+{
+  ___VOLATILE ___WORD *hcsh;
+
+  while ((hcsh=heap_chunks_to_scan_head) != heap_chunks_to_scan_tail)
+    {
+      ___WORD *ptr;
+
+#ifdef ___SINGLE_THREADED_VMS
+
+      ptr = ___UNTAG_AS(*hcsh, ___FORW);
+      heap_chunks_to_scan_head = ptr;
+      return ptr;
+
+#else
+
+      ___SHARED_MEMORY_BARRIER(); /* link is visible once tail is */
+
+      ptr = ___UNTAG_AS(*hcsh, ___FORW);
+
+      if (___COMPARE_AND_SWAP_WORD(___CAST(___VOLATILE ___WORD*,
+                                           &heap_chunks_to_scan_head),
+                                   ___CAST(___WORD,hcsh),
+                                   ___CAST(___WORD,ptr))
+          == ___CAST(___WORD,hcsh))
+        return ptr;
+
+#endif
+    }
+
+  return 0;
+}
+
+
 ___HIDDEN void set_heap_msection
    ___P((___processor_state ___ps,
          ___msection *ms),
@@ -4073,8 +4662,23 @@ ___WORD head;)
           if ((flags & ___GCHASHTABLE_FLAG_WEAK_KEYS) == 0 &&
               (flags & ___GCHASHTABLE_FLAG_MEM_ALLOC_KEYS))
             {
+              /*
+               * Marking a key updates its field when the key is
+               * movable, so a changed field means the key has moved.
+               * Tables whose keys are all still or permanent objects
+               * (such as symbols, procedures and large objects) are
+               * then not rehashed.
+               */
+
               for (i=words-2; i>=___GCHASHTABLE_KEY0; i-=2)
-                mark_array (___PSP body+i, 1); /* mark objects in key fields */
+                {
+                  ___WORD key = body[i];
+                  mark_array (___PSP body+i, 1); /* mark objects in key fields */
+                  if (body[i] != key)
+                    flags |= ___GCHASHTABLE_FLAG_KEY_MOVED;
+                }
+
+              body[___GCHASHTABLE_FLAGS] = ___FIX(flags);
             }
 
           if ((flags & ___GCHASHTABLE_FLAG_WEAK_VALS) == 0)
@@ -4207,6 +4811,90 @@ do { \
 #endif
 
 
+/*
+ * GC census.
+ *
+ * When a census is requested each processor counts the objects it
+ * scans during the GC, and their size, by subtype and for structures
+ * also by type descriptor.  The objects are counted after they are
+ * scanned, so the type descriptor of a structure is at its location
+ * after the GC.  Counting is done a complete heap chunk at a time so
+ * that the scanning loop is not slowed down when there is no census.
+ * Permanent objects are not counted.  The structures of the types
+ * that don't fit in the ___GC_CENSUS_NB_TYPES entries of the table of
+ * types of the processor are counted together in an "other" entry.
+ */
+
+___HIDDEN void census_obj
+   ___P((___PSD
+         ___WORD *body,
+         ___WORD head),
+        (___PSV
+         body,
+         head)
+___PSDKR
+___WORD *body;
+___WORD head;)
+{
+  ___PSGET
+  ___SIZE_TS words = ___HD_WORDS(head) + 1;
+  int subtype = ___HD_SUBTYPE(head);
+
+  gc_census_count[subtype]++;
+  gc_census_words[subtype] += words;
+
+  if (subtype == ___sSTRUCTURE)
+    {
+      ___WORD type = body[0];
+      int i = (___CAST(___UWORD,type) >> ___LWS) % ___GC_CENSUS_NB_TYPES;
+      int probes;
+
+      for (probes=0; probes<___GC_CENSUS_NB_TYPES; probes++)
+        {
+          if (gc_census_type_count[i] == 0)
+            {
+              gc_census_type[i] = type;
+              gc_census_type_words[i] = 0;
+            }
+
+          if (gc_census_type[i] == type)
+            {
+              gc_census_type_count[i]++;
+              gc_census_type_words[i] += words;
+              return;
+            }
+
+          i = (i+1) % ___GC_CENSUS_NB_TYPES;
+        }
+
+      gc_census_other_count++; /* the table of types is full */
+      gc_census_other_words += words;
+    }
+}
+
+
+___HIDDEN void census_objs
+   ___P((___PSD
+         ___WORD *ptr,
+         ___WORD *end),
+        (___PSV
+         ptr,
+         end)
+___PSDKR
+___WORD *ptr;
+___WORD *end;)
+{
+  ___PSGET
+
+  while (ptr < end)
+    {
+      ___WORD head = *ptr;
+      census_obj (___PSP ptr+1, head);
+      ptr += ___HD_WORDS(head) + 1;
+    }
+}
+
+
 ___HIDDEN void setup_still_objs_to_scan
    ___P((___PSDNC),
         (___PSVNC)
@@ -4244,7 +4932,9 @@ ___PSDKR)
     {
       ___WORD *body = base + ___STILL_BODY;
       still_objs_to_scan = base[___STILL_MARK];
-      scan (___PSP body, body[-1]);
+      gc_words_scanned += scan (___PSP body, body[-1]);
+      if (gc_census)
+        census_obj (___PSP body, body[-1]);
     }
 }
 
@@ -4270,6 +4960,11 @@ ___WORD *start;)
       scan_and_advance(ptr, head); /* note: this advances ptr */
     }
 
+  gc_words_scanned += ptr - start;
+
+  if (gc_census)
+    census_objs (___PSP start, ptr);
+
 #ifdef ENABLE_GC_ACTLOG_SCAN_COMPLETE_HEAP_CHUNK
   ___ACTLOG_END_PS();
 #endif
@@ -4319,10 +5014,10 @@ ___PSDKR)
    */
 
   ___WORD *ptr = scan_ptr;
-  ___VOLATILE ___WORD *hcsh;
 
   while (ptr != alloc_heap_ptr) /* SITUATION #1 or #2 ? */
     {
+      ___WORD *start = ptr;
       ___WORD head;
       while (!___TESTTYPE(head = *ptr, ___FORW)) /* not end of complete chunk? */
         {
@@ -4330,49 +5025,34 @@ ___PSDKR)
           if (ptr == alloc_heap_ptr) /* end of incomplete chunk? */
             {
               /* SITUATION #3, done scanning all movable objects */
+              gc_words_scanned += ptr - start;
+              if (gc_census)
+                census_objs (___PSP start, ptr);
               scan_ptr = ptr;
               return;
             }
         }
 
+      gc_words_scanned += ptr - start;
+
+      if (gc_census)
+        census_objs (___PSP start, ptr);
+
       scan_ptr = ptr; /* remember where scan ended */
 
       /*
        * SITUATION #1, at end of complete chunk.
        */
 
-#ifndef ___SINGLE_THREADED_VMS
-      ___SPINLOCK_LOCK(heap_chunks_to_scan_lock);
-#endif
-
-      while ((hcsh=heap_chunks_to_scan_head) != heap_chunks_to_scan_tail)
+      while ((ptr = pop_heap_chunk_to_scan (___ps)) != 0)
         {
           /*
-           * Get the next complete heap chunk from heap chunk FIFO and
-           * scan it.
+           * Scan the next complete heap chunk from heap chunk FIFO.
            */
 
-          ptr = ___UNTAG_AS(*hcsh, ___FORW);
-
-          heap_chunks_to_scan_head = ptr;
-
-          ___SHARED_MEMORY_BARRIER(); /* share heap_chunks_to_scan_head */
-
-#ifndef ___SINGLE_THREADED_VMS
-          ___SPINLOCK_UNLOCK(heap_chunks_to_scan_lock);
-#endif
-
           scan_complete_heap_chunk (___PSP ptr+1);
-
-#ifndef ___SINGLE_THREADED_VMS
-          ___SPINLOCK_LOCK(heap_chunks_to_scan_lock);
-#endif
         }
 
-#ifndef ___SINGLE_THREADED_VMS
-      ___SPINLOCK_UNLOCK(heap_chunks_to_scan_lock);
-#endif
-
       /*
        * Scan the incomplete heap chunk currently being created.
        */
@@ -4392,18 +5072,46 @@ ___PSDKR)
   ___PSGET
   ___WORD *last = &still_objs;
   ___WORD *base = ___CAST(___WORD*,*last);
+  ___WORD to_free = still_objs_to_free;
+  ___BOOL defer =
+    ___GC_SETTINGS_DEFER_STILL_FREE(___GSTATE->setup_params.gc_settings);
   ___SIZE_TS live_words_still = 0;
 
+  /*
+   * Return to the C heap the blocks that were not reused since the
+   * previous GC (after the GC when freeing is deferred).  The cache
+   * is then replenished with the blocks of the still objects that
+   * were found to be unreachable.
+   */
+
+  if (defer)
+    to_free = defer_still_cache (___ps, to_free);
+  else
+    free_still_cache (___ps);
+
   while (base != 0)
     {
       ___WORD link = base[___STILL_LINK];
       if (base[___STILL_MARK] == -1)
         {
-          ___WORD head = base[___STILL_BODY-1];
-          if (___HD_SUBTYPE(head) == ___sFOREIGN)
-            ___release_foreign
-              (___TAG(base + ___STILL_BODY - ___REFERENCE_TO_BODY, ___tSUBTYPED));
-          free_mem_aligned_heap (base);
+          if (defer)
+            {
+              /*
+               * Foreign objects are released during the GC as usual,
+               * but the memory of the object is returned to the C
+               * heap after the GC pause by free_still_objs_to_free.
+               */
+
+              release_foreign_still_obj (base);
+
+              if (!cache_still_block (___ps, base))
+                {
+                  base[___STILL_LINK] = to_free;
+                  to_free = ___CAST(___WORD,base);
+                }
+            }
+          else
+            release_still_obj (___ps, base);
         }
       else
         {
@@ -4416,6 +5124,9 @@ ___PSDKR)
 
   *last = 0;
 
+  still_objs_to_free = to_free;
+
+  gc_words_still_freed = words_still_objs - live_words_still;
   words_still_objs = live_words_still;
   words_still_objs_deferred = 0;
 
@@ -4441,13 +5152,22 @@ ___processor_state ___ps;)
   while (base != 0)
     {
       ___WORD link = base[___STILL_LINK];
-      ___WORD head = base[___STILL_BODY-1];
-      if (___HD_SUBTYPE(head) == ___sFOREIGN)
-        ___release_foreign
-          (___TAG(base + ___STILL_BODY - ___REFERENCE_TO_BODY, ___tSUBTYPED));
+      release_still_obj (___ps, base);
+      base = ___CAST(___WORD*,link);
+    }
+
+  base = ___CAST(___WORD*,still_objs_to_free);
+
+  still_objs_to_free = 0;
+
+  while (base != 0)
+    {
+      ___WORD link = base[___STILL_LINK];
       free_mem_aligned_heap (base);
       base = ___CAST(___WORD*,link);
     }
+
+  free_still_cache (___ps);
 }
 
 
@@ -4561,6 +5281,22 @@ ___processor_state ___ps;)
                          ? heap_avail
                          : heap_left_before_fudge);
 
+  /* lower the heap limit to the next allocation sampling point */
+
+  alloc_sample_base = alloc_heap_ptr;
+  alloc_sample_heap_limit = ___ps->heap_limit;
+
+  if (alloc_sample_interval != 0)
+    {
+      ___WORD *limit = alloc_heap_ptr;
+
+      if (!alloc_sample_armed)
+        limit += alloc_sample_countdown;
+
+      if (limit < ___ps->heap_limit)
+        ___ps->heap_limit = limit;
+    }
+
   /* set stack overflow and interrupt detection limit */
 
   ___refresh_interrupts_pstate (___ps);
@@ -4605,6 +5341,7 @@ ___processor_state ___ps;)
 {
   ___virtual_machine_state ___vms = ___VMSTATE_FROM_PSTATE(___ps);
   ___SCMOBJ err;
+  int c;
 
   /*
    * Setup processor's activity log.
@@ -4619,10 +5356,6 @@ ___processor_state ___ps;)
 
   tospace_offset = ___PSTATE_FROM_PROCESSOR_ID(0,___vms)->mem.tospace_offset_;
 
-#ifndef ___SINGLE_THREADED_VMS
-  ___SPINLOCK_INIT(heap_chunks_to_scan_lock);
-#endif
-
   /*
    * Allocate processor's stack and heap.
    */
@@ -4645,9 +5378,22 @@ ___processor_state ___ps;)
   /* Setup list of still objects. */
 
   still_objs = 0;
+  still_objs_to_free = 0;
+
+  for (c=0; c<___STILL_CACHE_NB_CLASSES; c++)
+    still_cache[c] = 0;
+
+  words_still_cache = 0;
   words_still_objs = 0;
   words_still_objs_deferred = 0;
 
+  /* No allocation sample pending */
+
+  alloc_sample_countdown = 0;
+  alloc_sample_base = 0;
+  alloc_sample_heap_limit = 0;
+  alloc_sample_armed = 0;
+
   /* Keep track of bytes allocated */
 
   bytes_allocated_minus_occupied = 0.0;
@@ -4730,6 +5476,7 @@ ___virtual_machine_state ___vms;)
 
   ___SIZE_TS init_heap_size;
   int init_nb_sections;
+  int i;
 
 #ifndef ___SINGLE_THREADED_VMS
 
@@ -4785,6 +5532,7 @@ ___virtual_machine_state ___vms;)
    */
 
   the_msections = 0;
+  msection_regions = 0;
 
   /*
    * Setup location of tospace.
@@ -4814,6 +5562,33 @@ ___virtual_machine_state ___vms;)
   latest_gc_movable = 0.0;
   latest_gc_still = 0.0;
 
+  for (i=0; i<___GC_NB_PHASES; i++)
+    {
+      gc_phase_time[i] = 0.0;
+      latest_gc_phase_time[i] = 0.0;
+    }
+
+  for (i=0; i<___GC_PAUSE_HIST_LENGTH; i++)
+    gc_pause_hist[i] = 0.0;
+
+  gc_max_pause = 0.0;
+  gc_bytes_copied = 0.0;
+  gc_bytes_still_freed = 0.0;
+  latest_gc_bytes_still_freed = 0.0;
+
+  /* Allocations are not sampled */
+
+  alloc_sample_interval = 0;
+
+  for (i=0; i<___ALLOC_SAMPLE_TABLE_LENGTH; i++)
+    alloc_sample_count[i] = 0;
+
+  alloc_samples_lost = 0;
+
+  /* No census of live objects during GC */
+
+  gc_census = 0;
+
   /* No custom msection allocator */
 
   custom_msection_alloc = 0;
@@ -4830,7 +5605,7 @@ ___virtual_machine_state ___vms;)
   SET_MAX(init_nb_sections,
           compute_nb_msections_min(___vms->processor_count));
 
-  adjust_msections (&the_msections, init_nb_sections);
+  adjust_msections (___vms, &the_msections, init_nb_sections);
 
   if (the_msections == 0 ||
       the_msections->nb_sections != init_nb_sections)
@@ -4963,7 +5738,7 @@ ___virtual_machine_state ___vms;)
 
   ___cleanup_mem_pstate (___PSTATE_FROM_PROCESSOR_ID(0,___vms));/*TODO: other processors?*/
 
-  free_msections (&the_msections);
+  free_msections (___vms, &the_msections);
 
 #ifndef ___SINGLE_VM
 
@@ -5062,6 +5837,8 @@ ___PSDKR)
 
       mark_array (___PSP &will, 1);
 
+      gc_wills++;
+
       *tail_exec = ___TAG(___SUBTYPED_TO_START(will),___EXECUTABLE_WILL);
       tail_exec = &___BODY0_AS(will,___tSUBTYPED)[___WILL_NEXT];
       curr = *tail_exec;
@@ -5078,10 +5855,14 @@ ___PSDKR)
 
       mark_array (___PSP &will, 1);
 
+      gc_wills++;
+
       if (___BODY0_AS(will,___tSUBTYPED)[___WILL_NEXT] & ___EXECUTABLE_WILL)
         {
           /* move will to executable will list */
 
+          gc_wills_executable++;
+
           *tail_exec = ___TAG(___SUBTYPED_TO_START(will),___EXECUTABLE_WILL);
           tail_exec = &___BODY0_AS(will,___tSUBTYPED)[___WILL_NEXT];
           curr = *tail_exec;
@@ -5712,8 +6493,11 @@ ___PSDKR)
                 }
             }
 
-          if (flags & ___GCHASHTABLE_FLAG_MEM_ALLOC_KEYS)
-            flags |= ___GCHASHTABLE_FLAG_KEY_MOVED; /* assume worst case */
+          /*
+           * The key fields were updated when the GC hash table was
+           * scanned, and the KEY_MOVED flag was set at that time if
+           * any key moved.
+           */
         }
 
       body[___GCHASHTABLE_FLAGS] = ___FIX(flags);
@@ -6381,6 +7165,22 @@ ___SIZE_TS requested_words_still;)
 
       SET_MAX(ths, recent_history);
 
+      if (___GSTATE->setup_params.max_heap_soft > 0)
+        {
+          /*
+           * Keep the heap below the soft limit set with the
+           * max-heap-soft runtime option, ignoring the history, by
+           * making the GC more frequent.  The limit is exceeded only
+           * when the live objects and the overflow reserve would not
+           * fit.
+           */
+
+          SET_MIN(ths,
+                  ___CAST(___SIZE_TS,
+                          (___GSTATE->setup_params.max_heap_soft >> ___LWS)));
+          SET_MAX(ths, live + 2*normal_overflow_reserve);
+        }
+
       target_movable_space = ths - occupied_words_still;
 
       /*
@@ -6438,7 +7238,7 @@ ___SIZE_TS requested_words_still;)
         break;
     }
 
-  adjust_msections (&the_msections, target_nb_sections);
+  adjust_msections (___vms, &the_msections, target_nb_sections);
 
   /*
    * Detect heap overflows caused by failure to allocate msections
@@ -6664,6 +7464,30 @@ ___PSDKR)
 }
 
 
+#ifndef ___SINGLE_THREADED_VMS
+
+___HIDDEN ___BOOL heap_chunks_to_scan_available
+   ___P((___virtual_machine_state ___vms),
+        (___vms)
+___virtual_machine_state ___vms;)
+{
+  int np = ___vms->processor_count;
+  int i;
+
+  for (i=0; i<np; i++)
+    {
+      ___processor_state ps = ___PSTATE_FROM_PROCESSOR_ID(i,___vms);
+      if (ps->mem.heap_chunks_to_scan_head_ !=
+          ps->mem.heap_chunks_to_scan_tail_)
+        return 1;
+    }
+
+  return 0;
+}
+
+#endif
+
+
 ___HIDDEN void mark_reachable_from_marked
    ___P((___PSDNC),
         (___PSVNC)
@@ -6677,6 +7501,7 @@ ___PSDKR)
   ___VOLATILE ___WORD *workers_count = &scan_workers_count[traverse_weak_refs];
   int np = ___vms->processor_count;
   int id = ___PROCESSOR_ID(___ps,___vms); /* id of this processor */
+  unsigned int rnd = (id+1) * 2654435761U; /* seed of victim selection */
   int i;
 
  continue_local_scan:
@@ -6692,54 +7517,53 @@ ___PSDKR)
 #ifndef ___SINGLE_THREADED_VMS
 
 #define ___GC_SCAN_STEAL_WORK_CYCLES 1000
+#define ___GC_SCAN_IDLE_SPIN_TIMEOUT 2000
 
   for (;;)
     {
-      /* Try stealing a queued chunk from another processor */
+      /*
+       * Try stealing a queued chunk from another processor.  The
+       * victims are chosen pseudo-randomly so that idle processors
+       * don't all contend for the FIFO of the same processor.
+       */
 
       for (i = (np-1) * ___GC_SCAN_STEAL_WORK_CYCLES - 1; i>=0; i--)
         {
-          ___processor_state ps = ___PSTATE_FROM_PROCESSOR_ID((i + i%(np-1) + 1) % np,___vms);
-          ___VOLATILE ___WORD *hcsh;
-
-          if (ps->mem.heap_chunks_to_scan_head_ !=
-              ps->mem.heap_chunks_to_scan_tail_)
-            {
-              /* only try stealing when chunk FIFO is non-empty */
-
-              ___SPINLOCK_LOCK(ps->mem.heap_chunks_to_scan_lock_);
-
-              if ((hcsh=ps->mem.heap_chunks_to_scan_head_) !=
-                  ps->mem.heap_chunks_to_scan_tail_)
-                {
-                  /* chunk FIFO is really non-empty */
+          ___processor_state ps;
+          ___WORD *ptr;
 
-                  ___WORD *ptr = ___UNTAG_AS(*hcsh, ___FORW);
+          rnd ^= rnd << 13; /* xorshift pseudo-random number generator */
+          rnd ^= rnd >> 17;
+          rnd ^= rnd << 5;
 
-                  ps->mem.heap_chunks_to_scan_head_ = ptr;
+          ps = ___PSTATE_FROM_PROCESSOR_ID((id + 1 + rnd % (np-1)) % np,___vms);
 
-                  ___SHARED_MEMORY_BARRIER(); /* share heap_chunks_to_scan_head */
+          /* only try stealing when chunk FIFO is non-empty */
 
-                  ___SPINLOCK_UNLOCK(ps->mem.heap_chunks_to_scan_lock_);
+          if (ps->mem.heap_chunks_to_scan_head_ !=
+              ps->mem.heap_chunks_to_scan_tail_ &&
+              (ptr = pop_heap_chunk_to_scan (ps)) != 0)
+            {
+              gc_chunks_stolen++;
 
-                  scan_complete_heap_chunk (___PSP ptr+1);
+              scan_complete_heap_chunk (___PSP ptr+1);
 
-                  goto continue_local_scan;
-                }
-              else
-                {
-                  ___SPINLOCK_UNLOCK(ps->mem.heap_chunks_to_scan_lock_);
-                }
+              goto continue_local_scan;
             }
         }
 
-      /* Signal being idle and wait for more work or termination */
-
-      ___MUTEX_LOCK(scan_termination_mutex);
+      /*
+       * Signal being idle.  The scan has terminated when there are no
+       * more active processors, because only active processors add
+       * chunks to their FIFO and they only become idle when their
+       * FIFO is empty.
+       */
 
-      if (--(*workers_count) == 0)
+      if (___FETCH_AND_ADD_WORD(workers_count, -1) == 1)
         {
-          /* Scan has terminated */
+          /* Scan has terminated, wake up the processors that sleep */
+
+          ___MUTEX_LOCK(scan_termination_mutex);
 
           for (i=np-1; i>=0; i--)
             ___CONDVAR_SIGNAL(scan_termination_condvar);
@@ -6748,30 +7572,148 @@ ___PSDKR)
 
           break;
         }
-      else
-        {
-          /* Other processors are still actively scanning chunks */
 
-          ___ACTLOG_BEGIN_PS(gc_wait,lightgray);
-          ___CONDVAR_WAIT(scan_termination_condvar,scan_termination_mutex);
-          ___ACTLOG_END_PS();
+      /*
+       * Other processors are still actively scanning chunks.  Wait
+       * for more work or termination, by spinning for a while and
+       * then sleeping.  A processor becomes active again by
+       * incrementing the active processor count, which is only
+       * allowed if it isn't 0 (otherwise the scan has terminated).
+       */
 
-          if (*workers_count == 0)
-            {
-              ___MUTEX_UNLOCK(scan_termination_mutex);
-              break;
-            }
+      {
+        int loops_left = ___GC_SCAN_IDLE_SPIN_TIMEOUT;
+        ___WORD count;
 
-          (*workers_count)++;
+        for (;;)
+          {
+            if ((count = *workers_count) == 0)
+              goto scan_terminated;
 
-          ___MUTEX_UNLOCK(scan_termination_mutex);
-        }
+            if (heap_chunks_to_scan_available (___vms))
+              {
+                if (___COMPARE_AND_SWAP_WORD(workers_count, count, count+1)
+                    == count)
+                  break;
+              }
+            else if (--loops_left > 0)
+              ___CPU_RELAX();
+            else
+              {
+                /*
+                 * A processor adding chunks to its FIFO signals the
+                 * condition variable without locking the mutex, so
+                 * the wakeup may be missed.  This only delays the
+                 * idle processor until the end of the scan.
+                 */
+
+                loops_left = ___GC_SCAN_IDLE_SPIN_TIMEOUT;
+
+                ___MUTEX_LOCK(scan_termination_mutex);
+
+                if (*workers_count != 0 &&
+                    !heap_chunks_to_scan_available (___vms))
+                  {
+                    ___ACTLOG_BEGIN_PS(gc_wait,lightgray);
+                    ___CONDVAR_WAIT(scan_termination_condvar,scan_termination_mutex);
+                    ___ACTLOG_END_PS();
+                  }
+
+                ___MUTEX_UNLOCK(scan_termination_mutex);
+              }
+          }
+      }
     }
 
+ scan_terminated:;
+
 #endif
 }
 
 
+/*
+ * 'gc_phase_end (___ps, phase, start)' adds to the duration of the
+ * phase 'phase' of the current GC the real time elapsed since 'start'
+ * and returns the current real time.  When 'phase' is negative only
+ * the current real time is returned.
+ */
+
+___HIDDEN ___F64 gc_phase_end
+   ___P((___processor_state ___ps,
+         int phase,
+         ___F64 start),
+        (___ps,
+         phase,
+         start)
+___processor_state ___ps;
+int phase;
+___F64 start;)
+{
+  ___time tim;
+  ___F64 now;
+
+  ___time_get_current_time (&tim);
+  now = ___time_to_seconds (tim);
+
+  if (phase >= 0)
+    latest_gc_phase_time[phase] += now - start;
+
+  return now;
+}
+
+
+___HIDDEN void record_gc_telemetry
+   ___P((___processor_state ___ps,
+         ___F64 pause),
+        (___ps,
+         pause)
+___processor_state ___ps;
+___F64 pause;)
+{
+  ___virtual_machine_state ___vms = ___VMSTATE_FROM_PSTATE(___ps);
+  ___SIZE_TS still_freed = 0;
+  ___F64 usecs = pause * 1e6;
+  int np = ___vms->processor_count;
+  int i;
+
+  for (i=0; i<___GC_NB_PHASES; i++)
+    gc_phase_time[i] += latest_gc_phase_time[i];
+
+  /*
+   * Bucket 0 counts the pauses shorter than 1 microsecond and bucket
+   * i > 0 counts the pauses in the range [2^(i-1),2^i) microseconds
+   * (the last bucket also counts all the longer pauses).
+   */
+
+  i = 0;
+
+  while (usecs >= 1.0 && i < ___GC_PAUSE_HIST_LENGTH-1)
+    {
+      usecs *= 0.5;
+      i++;
+    }
+
+  gc_pause_hist[i] += 1.0;
+
+  if (pause > gc_max_pause)
+    gc_max_pause = pause;
+
+  /*
+   * The collector is a copying collector so the live movable objects
+   * are exactly the objects that were copied.
+   */
+
+  gc_bytes_copied += latest_gc_movable;
+
+  for (i=0; i<np; i++)
+    still_freed +=
+      ___PSTATE_FROM_PROCESSOR_ID(i,___vms)->mem.gc_words_still_freed_;
+
+  latest_gc_bytes_still_freed = ___CAST(___F64,still_freed) * ___WS;
+  gc_bytes_still_freed += latest_gc_bytes_still_freed;
+}
+
+
 ___HIDDEN void garbage_collect_setup_phase
    ___P((___PSDNC),
         (___PSVNC)
@@ -6804,6 +7746,30 @@ ___PSDKR)
   words_still_objs += words_still_objs_deferred;
   words_still_objs_deferred = 0;
 
+  /* Reset the processor's GC telemetry counters */
+
+  gc_words_scanned = 0;
+  gc_chunks_stolen = 0;
+  gc_wills = 0;
+  gc_wills_executable = 0;
+
+  if (gc_census)
+    {
+      int i;
+
+      for (i=0; i<(1<<___SB); i++)
+        {
+          gc_census_count[i] = 0;
+          gc_census_words[i] = 0;
+        }
+
+      for (i=0; i<___GC_CENSUS_NB_TYPES; i++)
+        gc_census_type_count[i] = 0;
+
+      gc_census_other_count = 0;
+      gc_census_other_words = 0;
+    }
+
 #ifdef ENABLE_GC_ACTLOG_PHASES
   ___ACTLOG_END_PS();
 #endif
@@ -6895,7 +7861,14 @@ ___PSDKR)
 
   traverse_weak_refs = 1; /* traverse weak references in this phase */
 
-  process_wills (___PSPNC);
+  if (___PROCESSOR_ID(___ps,___vms) == 0)
+    {
+      ___F64 start = gc_phase_end (___ps, -1, 0.0);
+      process_wills (___PSPNC);
+      gc_phase_end (___ps, ___GC_PHASE_WILLS, start);
+    }
+  else
+    process_wills (___PSPNC);
 
   mark_reachable_from_marked (___PSPNC);
 
@@ -6925,7 +7898,14 @@ ___PSDKR)
   BARRIER();
 #endif
 
-  process_gc_hash_tables (___PSPNC);
+  if (___PROCESSOR_ID(___ps,___vms) == 0)
+    {
+      ___F64 start = gc_phase_end (___ps, -1, 0.0);
+      process_gc_hash_tables (___PSPNC);
+      gc_phase_end (___ps, ___GC_PHASE_GC_HASH_TABLES, start);
+    }
+  else
+    process_gc_hash_tables (___PSPNC);
 
   free_unmarked_still_objs (___PSPNC);
 
@@ -6948,6 +7928,7 @@ ___SIZE_TS requested_words_still;)
   ___F64 user_time_start, sys_time_start, real_time_start;
   ___F64 user_time_end, sys_time_end, real_time_end;
   ___F64 user_time, sys_time, real_time;
+  ___F64 phase_start = 0.0;
 
   ___ACTLOG_BEGIN_PS(gc,red);
 
@@ -6955,10 +7936,14 @@ ___SIZE_TS requested_words_still;)
 
   if (___PROCESSOR_ID(___ps,___vms) == 0)
     {
+      int i;
 #ifdef ENABLE_GC_TRACE_PHASES
       ___printf ("----------------------------------------- GC START #%d\n", ___CAST(int,nb_gcs)+1);
 #endif
       ___process_times (&user_time_start, &sys_time_start, &real_time_start);
+      for (i=0; i<___GC_NB_PHASES; i++)
+        latest_gc_phase_time[i] = 0.0;
+      phase_start = gc_phase_end (___ps, -1, 0.0);
     }
 
   /* Print debugging info */
@@ -7008,6 +7993,9 @@ ___SIZE_TS requested_words_still;)
 
   BARRIER();
 
+  if (___PROCESSOR_ID(___ps,___vms) == 0)
+    phase_start = gc_phase_end (___ps, ___GC_PHASE_SETUP, phase_start);
+
 
   /* Mark the objects that are reachable strongly */
 
@@ -7015,6 +8003,9 @@ ___SIZE_TS requested_words_still;)
 
   BARRIER();
 
+  if (___PROCESSOR_ID(___ps,___vms) == 0)
+    phase_start = gc_phase_end (___ps, ___GC_PHASE_MARK_STRONG, phase_start);
+
 
   /* Mark the objects that are reachable weakly */
 
@@ -7022,6 +8013,9 @@ ___SIZE_TS requested_words_still;)
 
   BARRIER();
 
+  if (___PROCESSOR_ID(___ps,___vms) == 0)
+    phase_start = gc_phase_end (___ps, ___GC_PHASE_MARK_WEAK, phase_start);
+
 
   /* Process gc hash tables and free unreachable still objects */
 
@@ -7033,7 +8027,10 @@ ___SIZE_TS requested_words_still;)
   /* Resize heap */
 
   if (___PROCESSOR_ID(___ps,___vms) == 0)
-    overflow = resize_heap (___vms, requested_words_still);
+    {
+      overflow = resize_heap (___vms, requested_words_still);
+      gc_phase_end (___ps, ___GC_PHASE_CLEANUP, phase_start);
+    }
 
   BARRIER();
 
@@ -7068,6 +8065,8 @@ ___SIZE_TS requested_words_still;)
       latest_gc_sys_time = sys_time;
       latest_gc_real_time = real_time;
 
+      record_gc_telemetry (___ps, real_time);
+
       ___raise_interrupt_pstate (___ps, ___INTR_GC); /* raise gc interrupt */
 
 #ifdef ENABLE_GC_TRACE_PHASES
@@ -7445,6 +8444,19 @@ ___PSDKR)
   alloc_stack_ptr = ___ps->fp;
   alloc_heap_ptr  = ___ps->hp;
 
+  /* Sample allocations and resume if heap limit was lowered for it */
+
+  if (alloc_sample_interval != 0 && sample_heap_alloc (___ps))
+    {
+      prepare_mem_pstate (___ps);
+      return 0;
+    }
+
+  /* Reclaim some of the still objects left unfreed by the last GC */
+
+  if (still_objs_to_free != 0)
+    free_still_objs_to_free (___ps, ___STILL_FREE_BATCH);
+
 #ifdef ___DEBUG_HEAP_LIMIT
   ___ps->heap_limit_line = line;
   ___ps->heap_limit_file = file;
@@ -7523,4 +8535,174 @@ ___PSDKR)
 }
 
 
+/*---------------------------------------------------------------------------*/
+
+/*
+ * '___alloc_sampling_set (___ps, bytes)' clears the allocation samples
+ * and starts sampling an allocation every time a processor has
+ * allocated 'bytes' bytes, or stops the sampling when 'bytes' is not
+ * positive.  The new sampling interval takes effect when the heap
+ * limit of each processor is next computed.
+ */
+
+void ___alloc_sampling_set
+   ___P((___processor_state ___ps,
+         ___SIZE_TS bytes),
+        (___ps,
+         bytes)
+___processor_state ___ps;
+___SIZE_TS bytes;)
+{
+  ___virtual_machine_state ___vms = ___VMSTATE_FROM_PSTATE(___ps);
+  ___SIZE_TS words = (bytes > 0) ? ___WORDS(bytes) : 0;
+  int i;
+
+  MISC_MEM_LOCK();
+
+  for (i=0; i<___ALLOC_SAMPLE_TABLE_LENGTH; i++)
+    alloc_sample_count[i] = 0;
+
+  alloc_samples_lost = 0;
+
+  MISC_MEM_UNLOCK();
+
+  for (i=0; i<___vms->processor_count; i++)
+    {
+      ___processor_state ps = ___PSTATE_FROM_PROCESSOR_ID(i,___vms);
+      ps->mem.alloc_sample_countdown_ = words;
+      ps->mem.alloc_sample_armed_ = 0;
+    }
+
+  alloc_sample_interval = words;
+}
+
+
+/*
+ * '___alloc_sampling_get (___ps, vect)' stores the allocation samples
+ * in the vector 'vect', which must have a length of at least 3 times
+ * ___ALLOC_SAMPLE_TABLE_LENGTH, as consecutive triples of the return
+ * address of the allocating code (#f if unknown), the subtype of the
+ * objects allocated and the number of samples.  The number of triples
+ * stored is returned.
+ */
+
+int ___alloc_sampling_get
+   ___P((___processor_state ___ps,
+         ___SCMOBJ vect),
+        (___ps,
+         vect)
+___processor_state ___ps;
+___SCMOBJ vect;)
+{
+  int i;
+  int n = 0;
+
+  MISC_MEM_LOCK();
+
+  for (i=0; i<___ALLOC_SAMPLE_TABLE_LENGTH; i++)
+    if (alloc_sample_count[i] != 0)
+      {
+        ___VECTORELEM(vect,3*n) = alloc_sample_ra[i];
+        ___VECTORELEM(vect,3*n+1) = ___FIX(alloc_sample_subtype[i]);
+        ___VECTORELEM(vect,3*n+2) = ___FIX(alloc_sample_count[i]);
+        n++;
+      }
+
+  MISC_MEM_UNLOCK();
+
+  return n;
+}
+
+
+/*
+ * '___gc_census_get (___ps, vect)' stores in the vector 'vect' the
+ * census of the live objects taken by the latest GC, merged over all
+ * the processors.  Elements 2*s and 2*s+1 are the number of objects
+ * of subtype s and the bytes they occupy, and they are followed by
+ * triples of a structure type descriptor, the number of structures of
+ * that type and the bytes they occupy.  When some structures were
+ * not counted by type because the table of types of a processor was
+ * full, the last triple has #t as the type descriptor and counts these
+ * structures.  The vector must have a length of at least 2*(1<<___SB)
+ * + 3*___GC_CENSUS_NB_TYPES times the number of processors + 3, and
+ * the elements following the last triple are set to #f.  The number
+ * of triples stored is returned.
+ */
+
+int ___gc_census_get
+   ___P((___processor_state ___ps,
+         ___SCMOBJ vect),
+        (___ps,
+         vect)
+___processor_state ___ps;
+___SCMOBJ vect;)
+{
+  ___virtual_machine_state ___vms = ___VMSTATE_FROM_PSTATE(___ps);
+  int start = 2*(1<<___SB);
+  int len = ___INT(___VECTORLENGTH(vect));
+  int n = 0;
+  ___SIZE_TS other_count = 0;
+  ___SIZE_TS other_words = 0;
+  int p;
+  int i;
+  int j;
+
+  for (i=0; i<len; i++)
+    ___VECTORELEM(vect,i) = (i < start) ? ___FIX(0) : ___FAL;
+
+  for (p=0; p<___vms->processor_count; p++)
+    {
+      ___processor_state ps = ___PSTATE_FROM_PROCESSOR_ID(p,___vms);
+
+      for (i=0; i<(1<<___SB); i++)
+        {
+          ___VECTORELEM(vect,2*i) =
+            ___FIXADD(___VECTORELEM(vect,2*i),
+                      ___FIX(ps->mem.gc_census_count_[i]));
+          ___VECTORELEM(vect,2*i+1) =
+            ___FIXADD(___VECTORELEM(vect,2*i+1),
+                      ___FIX(ps->mem.gc_census_words_[i] << ___LWS));
+        }
+
+      other_count += ps->mem.gc_census_other_count_;
+      other_words += ps->mem.gc_census_other_words_;
+
+      for (i=0; i<___GC_CENSUS_NB_TYPES; i++)
+        if (ps->mem.gc_census_type_count_[i] != 0)
+          {
+            ___WORD type = ps->mem.gc_census_type_[i];
+
+            for (j=0; j<n; j++)
+              if (___VECTORELEM(vect,start+3*j) == type)
+                break;
+
+            if (j == n)
+              {
+                ___VECTORELEM(vect,start+3*j) = type;
+                ___VECTORELEM(vect,start+3*j+1) = ___FIX(0);
+                ___VECTORELEM(vect,start+3*j+2) = ___FIX(0);
+                n++;
+              }
+
+            ___VECTORELEM(vect,start+3*j+1) =
+              ___FIXADD(___VECTORELEM(vect,start+3*j+1),
+                        ___FIX(ps->mem.gc_census_type_count_[i]));
+            ___VECTORELEM(vect,start+3*j+2) =
+              ___FIXADD(___VECTORELEM(vect,start+3*j+2),
+                        ___FIX(ps->mem.gc_census_type_words_[i] << ___LWS));
+          }
+    }
+
+  if (other_count != 0)
+    {
+      ___VECTORELEM(vect,start+3*n) = ___TRU;
+      ___VECTORELEM(vect,start+3*n+1) = ___FIX(other_count);
+      ___VECTORELEM(vect,start+3*n+2) = ___FIX(other_words << ___LWS);
+      n++;
+    }
+
+  return n;
+}
+
+
 /*---------------------------------------------------------------------------*/
@@ -57,6 +57,24 @@
  * ___MAX_STILL_DEFERRED is the maximum number of words that are
  * allocated per processor to still objects before they are accounted for
  * at the VM level.
+ *
+ * ___STILL_CACHE_MIN_WORDS is the size in words of the smallest size
+ * class of the per-processor still object block cache.  The size
+ * classes grow geometrically (256, 384, 512, 768, 1024, ...).
+ *
+ * ___STILL_CACHE_MAX_WORDS is the maximum number of words that a
+ * processor keeps in its still object block cache.
+ *
+ * ___MSECTION_REGION_SLOTS is the maximum number of msections in a
+ * region of memory pages obtained from the operating system.
+ *
+ * ___HUGE_PAGE_SIZE is the size in bytes of huge pages, which is also
+ * the alignment of the regions.
+ *
+ * ___STILL_FREE_BATCH is the maximum number of unreachable still
+ * objects that are freed by a processor each time it allocates a still
+ * object or a new msection, when the GC defers the freeing of still
+ * objects (-:gc-defer-still-free runtime option).
  */
 
 
@@ -77,6 +95,11 @@
 (4*2*((___MAX_NB_PARMS+___SUBTYPED_BODY) + \
  ___MAX_NB_ARGS*(___PAIR_SIZE+___PAIR_BODY)))
 #define ___MAX_STILL_DEFERRED   1024
+#define ___MSECTION_REGION_SLOTS 31
+#define ___HUGE_PAGE_SIZE       (2*1024*1024)
+#define ___STILL_FREE_BATCH     64
+#define ___STILL_CACHE_MIN_WORDS 256
+#define ___STILL_CACHE_MAX_WORDS ___MSECTION_SIZE
 
 
 /* 
@@ -165,6 +188,11 @@ extern ___SCMOBJ ___hash_scheme_string
    ___P((___SCMOBJ str),
         ());
 
+extern void ___reserve_symkey_table
+   ___P((unsigned int subtype,
+         ___SIZE_TS n),
+        ());
+
 extern void ___intern_symkey
    ___P((___SCMOBJ symkey),
         ());
@@ -246,5 +274,20 @@ extern ___F64 ___bytes_allocated
    ___P((___PSDNC),
         ());
 
+extern void ___alloc_sampling_set
+   ___P((___processor_state ___ps,
+         ___SIZE_TS bytes),
+        ());
+
+extern int ___alloc_sampling_get
+   ___P((___processor_state ___ps,
+         ___SCMOBJ vect),
+        ());
+
+extern int ___gc_census_get
+   ___P((___processor_state ___ps,
+         ___SCMOBJ vect),
+        ());
+
 
 #endif
@@ -339,6 +339,26 @@
 
 #ifdef HAVE_MMAP
 #define USE_mmap
+#ifdef HAVE_MADVISE
+#define USE_madvise
+#endif
+#ifdef HAVE_SYS_SYSCALL_H
+#ifdef HAVE_LINUX_IO_URING_H
+#define USE_io_uring
+#endif
+#endif
+#endif
+
+#ifdef HAVE_SENDFILE
+#ifdef HAVE_SYS_SENDFILE_H
+#define USE_sendfile
+#endif
+#endif
+
+#ifdef HAVE_SPLICE
+#ifdef HAVE_SYS_SYSCALL_H
+#define USE_splice_syscall
+#endif
 #endif
 
 #ifdef HAVE_FCNTL
@@ -739,9 +759,20 @@
 #undef HAVE_POLL
 #endif
 
+#ifndef USE_EPOLL_FOR_SELECT
+#undef HAVE_EPOLL_CREATE1
+#endif
+
+#ifndef HAVE_SYS_EPOLL_H
+#undef HAVE_EPOLL_CREATE1
+#endif
+
 #ifdef HAVE_MSGWAITFORMULTIPLEOBJECTS
 #define USE_MsgWaitForMultipleObjects
 #else
+#ifdef HAVE_EPOLL_CREATE1
+#define USE_epoll
+#else
 #ifdef HAVE_POLL
 #define USE_poll
 #ifdef HAVE_PPOLL
@@ -753,12 +784,17 @@
 #endif
 #endif
 #endif
+#endif
 
 #ifdef USE_select
 #define USE_select_or_poll
 #else
 #ifdef USE_poll
 #define USE_select_or_poll
+#else
+#ifdef USE_epoll
+#define USE_select_or_poll
+#endif
 #endif
 #endif
 
@@ -802,6 +838,12 @@
 #endif
 
 
+#ifdef USE_epoll
+#undef USE_timeval
+#define USE_timeval
+#endif
+
+
 #ifdef USE_select
 #undef USE_timeval
 #define USE_timeval
@@ -1151,6 +1193,10 @@ ___END_C_LINKAGE
 #define INCLUDE_sys_types_h
 #undef INCLUDE_sys_mman_h
 #define INCLUDE_sys_mman_h
+#ifdef USE_sysconf
+#undef INCLUDE_unistd_h
+#define INCLUDE_unistd_h
+#endif
 #endif
 
 #ifdef USE_gethostname
@@ -1383,6 +1429,11 @@ ___END_C_LINKAGE
 #define INCLUDE_poll_h
 #endif
 
+#ifdef USE_epoll
+#undef INCLUDE_sys_epoll_h
+#define INCLUDE_sys_epoll_h
+#endif
+
 #ifdef USE_fcntl
 #undef INCLUDE_fcntl_h
 #define INCLUDE_fcntl_h
@@ -1395,6 +1446,25 @@ ___END_C_LINKAGE
 #define INCLUDE_linux_fs_h
 #endif
 
+#ifdef USE_io_uring
+#undef INCLUDE_sys_syscall_h
+#define INCLUDE_sys_syscall_h
+#undef INCLUDE_linux_io_uring_h
+#define INCLUDE_linux_io_uring_h
+#endif
+
+#ifdef USE_sendfile
+#undef INCLUDE_sys_sendfile_h
+#define INCLUDE_sys_sendfile_h
+#endif
+
+#ifdef USE_splice_syscall
+#undef INCLUDE_sys_syscall_h
+#define INCLUDE_sys_syscall_h
+#undef INCLUDE_sys_ioctl_h
+#define INCLUDE_sys_ioctl_h
+#endif
+
 #ifdef USE_sched_getcpu
 #undef INCLUDE_sched_h
 #define INCLUDE_sched_h
@@ -1546,6 +1616,18 @@ kern_return_t thread_policy_set(thread_t thread,
 #endif
 #endif
 
+#ifdef INCLUDE_linux_io_uring_h
+#ifdef HAVE_LINUX_IO_URING_H
+#include <linux/io_uring.h>
+#endif
+#endif
+
+#ifdef INCLUDE_sys_sendfile_h
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#endif
+#endif
+
 #ifdef INCLUDE_syslog_h
 #ifdef HAVE_SYSLOG_H
 #include <syslog.h>
@@ -1923,6 +2005,12 @@ typedef unsigned int fpu_control_t __attribute__ ((__mode__ (__HI__)));
 #endif
 #endif
 
+#ifdef INCLUDE_sys_epoll_h
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
+#endif
+
 #ifdef INCLUDE_openssl_ssl_h
 #include <openssl/ssl.h>
 #endif
@@ -414,6 +414,126 @@ void *ptr;)
 }
 
 
+void *___alloc_mem_pages
+   ___P((___SIZE_T bytes,
+         ___SIZE_T alignment,
+         ___BOOL huge),
+        (bytes,
+         alignment,
+         huge)
+___SIZE_T bytes;
+___SIZE_T alignment;
+___BOOL huge;)
+{
+#ifndef USE_mmap
+
+  return NULL;
+
+#endif
+
+#ifdef USE_mmap
+
+  /*
+   * Map enough space to find an aligned block in it and unmap the
+   * unaligned head and tail.
+   */
+
+  char *ptr = ___CAST(char*,
+                      mmap (0,
+                            bytes + alignment,
+                            PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANON,
+                            -1,
+                            0));
+  char *aligned;
+
+  if (ptr == ___CAST(char*,MAP_FAILED))
+    return NULL;
+
+  aligned = ___CAST(char*,
+                    (___CAST(___UWORD,ptr) + alignment - 1) &
+                    ~___CAST(___UWORD,alignment - 1));
+
+  if (aligned != ptr)
+    munmap (ptr, aligned - ptr);
+
+  if (aligned + bytes != ptr + bytes + alignment)
+    munmap (aligned + bytes, (ptr + alignment) - aligned);
+
+#ifdef USE_madvise
+#ifdef MADV_HUGEPAGE
+
+  if (huge)
+    madvise (aligned, bytes, MADV_HUGEPAGE); /* only advisory */
+
+#endif
+#endif
+
+  return aligned;
+
+#endif
+}
+
+
+void ___free_mem_pages
+   ___P((void *ptr,
+         ___SIZE_T bytes),
+        (ptr,
+         bytes)
+void *ptr;
+___SIZE_T bytes;)
+{
+#ifdef USE_mmap
+
+  munmap (ptr, bytes);
+
+#endif
+}
+
+
+void ___decommit_mem_pages
+   ___P((void *ptr,
+         ___SIZE_T bytes),
+        (ptr,
+         bytes)
+void *ptr;
+___SIZE_T bytes;)
+{
+#ifdef USE_mmap
+#ifdef USE_madvise
+#ifdef MADV_DONTNEED
+
+  /*
+   * Only the pages entirely contained in the block are released.
+   */
+
+  ___UWORD page_size = 4096;
+  ___UWORD start;
+  ___UWORD end;
+
+#ifdef USE_sysconf
+#ifdef _SC_PAGESIZE
+
+  long n = sysconf (_SC_PAGESIZE);
+
+  if (n > 0)
+    page_size = n;
+
+#endif
+#endif
+
+  start = (___CAST(___UWORD,ptr) + page_size - 1) & ~(page_size - 1);
+  end = (___CAST(___UWORD,ptr) + bytes) & ~(page_size - 1);
+
+  if (start < end)
+    madvise (___CAST(void*,start), end - start, MADV_DONTNEED); /* only advisory */
+
+#endif
+#endif
+#endif
+}
+
+
 #ifdef ___DEBUG_ALLOC_MEM
 void *___alloc_mem_heap
    ___P((___SIZE_T bytes,
@@ -132,6 +132,37 @@ extern ___base_module ___base_mod;
 #define ___ALLOC_MEM_UP
 
 
+/*
+ * "___alloc_mem_pages" allocates a block of memory pages directly from
+ * the operating system, aligned on a multiple of "alignment" bytes (a
+ * power of two that is a multiple of the page size).  When "huge" is
+ * true the operating system is asked to back the block with huge
+ * pages when possible.  NULL is returned if the block can't be
+ * allocated or if the operating system doesn't support this kind of
+ * allocation, in which case the caller should use "___alloc_mem_heap".
+ * The block must be reclaimed with "___free_mem_pages".  The pages of
+ * a part of the block that is no longer used can be returned to the
+ * operating system with "___decommit_mem_pages" (the part stays mapped
+ * and reads as zeros when it is used again).
+ */
+
+extern void *___alloc_mem_pages
+   ___P((___SIZE_T bytes,
+         ___SIZE_T alignment,
+         ___BOOL huge),
+        ());
+
+extern void ___free_mem_pages
+   ___P((void *ptr,
+         ___SIZE_T bytes),
+        ());
+
+extern void ___decommit_mem_pages
+   ___P((void *ptr,
+         ___SIZE_T bytes),
+        ());
+
+
 /*---------------------------------------------------------------------------*/
 
 /* Program startup. */
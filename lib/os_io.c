@@ -50,6 +50,7 @@ int newsize;)
   void *readfds = NULL;
   void *writefds = NULL;
   void *exceptfds = NULL;
+  void *armed = NULL;
 
   if (newsize > 0)
     {
@@ -68,6 +69,17 @@ int newsize;)
       if (exceptfds == NULL)
         goto error;
 #endif
+
+#ifdef USE_epoll
+      /*
+       * The fds armed in the epoll instance are forgotten when the
+       * fdsets grow, so they will be rearmed by the next select.
+       */
+      armed = ___ALLOC_MEM(newsize);
+      if (armed == NULL)
+        goto error;
+      memset (armed, 0, newsize);
+#endif
     }
 
   if (___ps->os.fdset.readfds != NULL)
@@ -81,9 +93,13 @@ int newsize;)
     ___FREE_MEM(___ps->os.fdset.exceptfds);
 #endif
 
+  if (___ps->os.fdset.armed != NULL)
+    ___FREE_MEM(___ps->os.fdset.armed);
+
   ___ps->os.fdset.readfds = readfds;
   ___ps->os.fdset.writefds = writefds;
   ___ps->os.fdset.exceptfds = exceptfds;
+  ___ps->os.fdset.armed = armed;
   ___ps->os.fdset.size = newsize;
 
   return 1;
@@ -95,6 +111,8 @@ int newsize;)
     ___FREE_MEM(writefds);
   if (exceptfds != NULL)
     ___FREE_MEM(exceptfds);
+  if (armed != NULL)
+    ___FREE_MEM(armed);
 
   return 0;
 }
@@ -109,7 +127,10 @@ ___processor_state ___ps;)
   ___ps->os.fdset.readfds = NULL;
   ___ps->os.fdset.writefds = NULL;
   ___ps->os.fdset.exceptfds = NULL;
+  ___ps->os.fdset.armed = NULL;
   ___ps->os.fdset.size = 0;
+  ___ps->os.fdset.forget_count =
+    ___VMSTATE_FROM_PSTATE(___ps)->os.fdset.forget_count;
 
   return ___fdset_realloc (___ps, size);
 }
@@ -900,6 +921,107 @@ int for_op;)
 
 #endif
 
+#ifdef USE_epoll
+
+/*
+ * The registrations in the processor's epoll instance persist from
+ * one call of ___device_select to the next, so that each call only
+ * costs a system call for the fds that were not already armed.  The
+ * fds are armed with EPOLLONESHOT so that an fd that is no longer
+ * waited on is reported at most once.  The armed table remembers the
+ * events that are armed on each fd.  An entry is cleared when the fd
+ * is reported by epoll_wait (which disarms it) and when the fd is
+ * closed (which removes it from the epoll instance).
+ *
+ * A processor only clears the entries of its own armed table.  When
+ * an fd is closed, the VM's forget_count is incremented, and the
+ * other processors clear their whole armed table at their next select
+ * (the fd number may have been reused for a new fd that is not in
+ * their epoll instance).  An fd is then rearmed with EPOLL_CTL_MOD,
+ * or with EPOLL_CTL_ADD when the fd is not in the epoll instance.
+ */
+
+#define EPOLL_ARMED_READ  1
+#define EPOLL_ARMED_WRITE 2
+
+void ___device_select_add_fd
+   ___P((___device_select_state *state,
+         int fd,
+         int for_op),
+        (state,
+         fd,
+         for_op)
+___device_select_state *state;
+int fd;
+int for_op;)
+{
+  int armed = state->armed[fd];
+  int want = (for_op == FOR_READING) ? EPOLL_ARMED_READ : EPOLL_ARMED_WRITE;
+
+  ++state->fd_count;
+
+  if (!(armed & want))
+    {
+      struct epoll_event ev;
+
+      armed |= want;
+
+      ev.events = EPOLLONESHOT;
+      if (armed & EPOLL_ARMED_READ)
+        ev.events |= EPOLLIN;
+      if (armed & EPOLL_ARMED_WRITE)
+        ev.events |= EPOLLOUT;
+      ev.data.fd = fd;
+
+      if (epoll_ctl (state->epoll_fd, EPOLL_CTL_MOD, fd, &ev) < 0 &&
+          (errno != ENOENT ||
+           epoll_ctl (state->epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0))
+        {
+          /*
+           * The fd can't be monitored with epoll (for example a
+           * regular file), so it is reported as ready like poll does.
+           */
+
+          if (for_op == FOR_READING)
+            ___FD_SET(fd, state->readfds);
+          else
+            ___FD_SET(fd, state->writefds);
+
+          state->timeout = ___time_mod.time_neg_infinity;
+
+          return;
+        }
+
+      state->armed[fd] = armed;
+    }
+}
+
+
+void ___device_select_forget_fd
+   ___P((int fd),
+        (fd)
+int fd;)
+{
+  ___processor_state ___ps = ___PSTATE;
+  ___virtual_machine_state ___vms = ___VMSTATE_FROM_PSTATE(___ps);
+  ___WORD count;
+
+  if (fd >= 0 && fd < ___ps->os.fdset.size)
+    ___CAST(___U8*,___ps->os.fdset.armed)[fd] = 0;
+
+  count = ___FETCH_AND_ADD_WORD(&___vms->os.fdset.forget_count, 1);
+
+  /*
+   * The current processor's armed table stays valid when no other
+   * fd was forgotten since it was last validated.
+   */
+
+  if (___ps->os.fdset.forget_count == count)
+    ___ps->os.fdset.forget_count = count + 1;
+}
+
+#endif
+
 
 #ifdef USE_MsgWaitForMultipleObjects
 
@@ -995,6 +1117,29 @@ ___time timeout;)
   }
 #endif
 
+#ifdef USE_epoll
+  {
+    ___processor_state ___ps = ___PSTATE;
+    ___WORD count =
+      ___VMSTATE_FROM_PSTATE(___ps)->os.fdset.forget_count;
+
+    if (___ps->os.fdset.forget_count != count)
+      {
+        /* some fds were closed, so the armed table may be stale */
+        memset (___ps->os.fdset.armed, 0, ___ps->os.fdset.size);
+        ___ps->os.fdset.forget_count = count;
+      }
+
+    state.epoll_fd = ___ps->os.epoll_fd;
+    state.armed = ___CAST(___U8*, ___ps->os.fdset.armed);
+    state.fd_count = 0;
+    state.readfds = ___CAST(___fdbits*, ___ps->os.fdset.readfds);
+    state.writefds = ___CAST(___fdbits*, ___ps->os.fdset.writefds);
+    ___FD_ZERO(state.readfds, ___ps->os.fdset.size);
+    ___FD_ZERO(state.writefds, ___ps->os.fdset.size);
+  }
+#endif
+
 #ifdef USE_ASYNC_DEVICE_SELECT_ABORT
 
   /* monitor self-pipe for available data to read */
@@ -1335,6 +1480,84 @@ ___time timeout;)
   }
 #endif
 
+#ifdef USE_epoll
+  {
+    ___mask_heartbeat_interrupts_state heartbeat_interrupts;
+    struct timeval delta_tv_struct;
+    struct timeval *delta_tv = &delta_tv_struct;
+    struct epoll_event events[256];
+    int delta_msecs;
+    int result;
+
+    ___absolute_time_to_nonnegative_timeval_maybe_NULL (delta, &delta_tv);
+
+    if (delta_tv != NULL)
+      {
+        if (delta_tv->tv_sec < 0)
+          delta_msecs = 0;
+        else if (delta_tv->tv_sec < (INT_MAX / 1000))
+          delta_msecs = delta_tv->tv_sec * 1000 + delta_tv->tv_usec / 1000;
+        else
+          delta_msecs = INT_MAX;
+      }
+    else
+      delta_msecs = -1;
+
+    if (delta_msecs == 0 && state.fd_count == 0)
+      {
+        /* the timeout has already passed and there is nothing to check */
+
+        result = 0;
+        goto epoll_done;
+      }
+
+    /* see comments on select above regarding heartbeat interrupts */
+    ___mask_heartbeat_interrupts_begin (&heartbeat_interrupts);
+
+    result = epoll_wait (state.epoll_fd,
+                         events,
+                         sizeof (events) / sizeof (events[0]),
+                         delta_msecs);
+
+    if (result < 0)
+      e = err_code_from_errno ();
+
+    ___mask_heartbeat_interrupts_end (&heartbeat_interrupts);
+
+    /*
+     * Set the active bitmaps.  The fds that were not reported because
+     * the events buffer is full stay armed and will be reported by
+     * the next call to epoll_wait.
+     */
+
+    if (result > 0)
+      {
+        int errmask = (EPOLLERR | EPOLLHUP);
+        int x;
+
+        for (x = 0; x < result; ++x)
+          {
+            int fd = events[x].data.fd;
+            int armed = state.armed[fd];
+
+            if ((armed & EPOLL_ARMED_READ) &&
+                (events[x].events & (EPOLLIN | errmask)))
+              ___FD_SET(fd, state.readfds);
+
+            if ((armed & EPOLL_ARMED_WRITE) &&
+                (events[x].events & (EPOLLOUT | errmask)))
+              ___FD_SET(fd, state.writefds);
+
+            state.armed[fd] = 0; /* EPOLLONESHOT disarmed the fd */
+          }
+      }
+
+  epoll_done:
+
+    state.timeout_reached = (result == 0);
+  }
+#endif
+
 #endif
 
 #ifdef USE_MsgWaitForMultipleObjects
@@ -2967,6 +3190,9 @@ int direction;)
           == ___DIRECTION_RD)
         {
 #ifdef USE_POSIX
+#ifdef USE_epoll
+          ___device_select_forget_fd (d->fd_rd);
+#endif
           if (d->fd_rd >= 0 &&
               d->fd_rd != d->fd_wr &&
               ___close_no_EINTR (d->fd_rd) < 0)
@@ -2991,6 +3217,9 @@ int direction;)
           == ___DIRECTION_WR)
         {
 #ifdef USE_POSIX
+#ifdef USE_epoll
+          ___device_select_forget_fd (d->fd_wr);
+#endif
           if (d->fd_wr >= 0 &&
               ___close_no_EINTR (d->fd_wr) < 0)
             return err_code_from_errno ();
@@ -4916,6 +5145,9 @@ int direction;)
       if ((d->base.base.close_direction & (___DIRECTION_RD|___DIRECTION_WR))
           == (___DIRECTION_RD|___DIRECTION_WR))
         {
+#ifdef USE_epoll
+          ___device_select_forget_fd (d->s);
+#endif
           if (CLOSE_SOCKET(d->s) != 0)
             return ERR_CODE_FROM_SOCKET_CALL;
         }
@@ -5853,6 +6085,9 @@ int direction;)
       if ((d->base.close_direction & ___DIRECTION_RD)
           == ___DIRECTION_RD)
         {
+#ifdef USE_epoll
+          ___device_select_forget_fd (d->s);
+#endif
           if (CLOSE_SOCKET(d->s) != 0)
             return ERR_CODE_FROM_SOCKET_CALL;
         }
@@ -6204,6 +6439,9 @@ ___HIDDEN ___SCMOBJ ___device_udp_close_virt
       if ((d->base.close_direction & (___DIRECTION_RD|___DIRECTION_WR))
           == (___DIRECTION_RD|___DIRECTION_WR))
         {
+#ifdef USE_epoll
+          ___device_select_forget_fd (d->s);
+#endif
           if (CLOSE_SOCKET(d->s) != 0)
             return ERR_CODE_FROM_SOCKET_CALL;
         }
@@ -7151,122 +7389,516 @@ ___SCMOBJ *event;)
 
 /*---------------------------------------------------------------------------*/
 
-/* File stream device */
+/* Reading regular files with io_uring. */
 
-typedef struct ___device_file_struct
+#ifdef USE_io_uring
+
+/*
+ * According to select and poll a regular file is always ready, so
+ * reading one with read blocks the processor until the data is
+ * available.  When the -:io-uring runtime option is used, a file
+ * device that reads a regular file has an io_uring with a single
+ * entry.  The read is submitted to the ring and the device returns
+ * EAGAIN, so the Scheme thread waits for the ring's fd to become
+ * readable, which happens when the read completes.  The data is read
+ * into a buffer of the ring because the caller's buffer is in the
+ * Scheme heap and could move before the read completes.  If the ring
+ * can't be created or the kernel does not support the read operation
+ * the device falls back to read.
+ */
+
+#define ___IO_URING_BUF_SIZE 65536
+
+typedef struct ___io_uring_struct
   {
-    ___device_stream base;
+    int fd;
+    void *sq_ring;
+    void *cq_ring;
+    struct io_uring_sqe *sqes;
+    size_t sq_ring_size;
+    size_t cq_ring_size;
+    size_t sqes_size;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_cqe *cqes;
+    ___BOOL pending; /* has a read been submitted but not reaped? */
+    int result;      /* result of the last reaped read */
+    int lo;          /* start of unconsumed data in buf */
+    int hi;          /* end of unconsumed data in buf */
+    ___U8 buf[___IO_URING_BUF_SIZE];
+  } ___io_uring;
 
-#ifndef USE_POSIX
-#ifndef USE_WIN32
 
-    ___FILE *stream;
+___HIDDEN void ___io_uring_unmap
+   ___P((___io_uring *r),
+        (r)
+___io_uring *r;)
+{
+  if (r->sqes != MAP_FAILED)
+    munmap (r->sqes, r->sqes_size);
 
-#endif
-#endif
+  if (r->cq_ring != MAP_FAILED && r->cq_ring != r->sq_ring)
+    munmap (r->cq_ring, r->cq_ring_size);
 
-#ifdef USE_POSIX
-    int fd;
-#endif
+  if (r->sq_ring != MAP_FAILED)
+    munmap (r->sq_ring, r->sq_ring_size);
 
-#ifdef USE_WIN32
-    HANDLE h;
-    int flags;
+#ifdef USE_epoll
+  ___device_select_forget_fd (r->fd);
 #endif
-  } ___device_file;
 
-typedef struct ___device_file_vtbl_struct
-  {
-    ___device_stream_vtbl base;
-  } ___device_file_vtbl;
+  ___close_no_EINTR (r->fd); /* ignore error */
 
-___HIDDEN int ___device_file_kind
-   ___P((___device *self),
-        (self)
-___device *self;)
-{
-  return ___FILE_DEVICE_KIND;
+  ___FREE_MEM(r);
 }
 
-#if 0
 
-___HIDDEN void ___device_file_restore_initial_mode
-   ___P((___device_file *d),
-        (d)
-___device_file *d;)
+___HIDDEN ___io_uring *___io_uring_setup
+   ___P((int fd),
+        (fd)
+int fd;)
 {
-#ifdef USE_POSIX
+  struct stat s;
+  struct io_uring_params p;
+  ___io_uring *r;
 
-  /* set blocking mode */
+  if (fstat (fd, &s) < 0 || !S_ISREG(s.st_mode))
+    return NULL;
 
-  ___set_fd_blocking_mode (d->fd, 1); /* ignore error */
+  r = ___CAST(___io_uring*, ___ALLOC_MEM(sizeof (___io_uring)));
+
+  if (r == NULL)
+    return NULL;
+
+  memset (&p, 0, sizeof (p));
+
+  if ((r->fd = syscall (__NR_io_uring_setup, 1, &p)) < 0)
+    {
+      ___FREE_MEM(r);
+      return NULL;
+    }
+
+  r->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof (unsigned);
+  r->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof (struct io_uring_cqe);
+  r->sqes_size = p.sq_entries * sizeof (struct io_uring_sqe);
+
+  if (p.features & IORING_FEAT_SINGLE_MMAP)
+    {
+      if (r->cq_ring_size > r->sq_ring_size)
+        r->sq_ring_size = r->cq_ring_size;
+      r->cq_ring_size = r->sq_ring_size;
+    }
+
+  r->sq_ring = mmap (NULL,
+                     r->sq_ring_size,
+                     PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE,
+                     r->fd,
+                     IORING_OFF_SQ_RING);
 
+  if (r->sq_ring == MAP_FAILED)
+    r->cq_ring = MAP_FAILED;
+  else if (p.features & IORING_FEAT_SINGLE_MMAP)
+    r->cq_ring = r->sq_ring;
+  else
+    r->cq_ring = mmap (NULL,
+                       r->cq_ring_size,
+                       PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE,
+                       r->fd,
+                       IORING_OFF_CQ_RING);
+
+  if (r->cq_ring == MAP_FAILED)
+    r->sqes = ___CAST(struct io_uring_sqe*, MAP_FAILED);
+  else
+    r->sqes = ___CAST(struct io_uring_sqe*,
+                      mmap (NULL,
+                            r->sqes_size,
+                            PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE,
+                            r->fd,
+                            IORING_OFF_SQES));
+
+  if (r->sqes == MAP_FAILED
+#ifdef USE_FDSET_RESIZING
+      || !___fdset_resize (r->fd, r->fd)
 #endif
+     )
+    {
+      ___io_uring_unmap (r);
+      return NULL;
+    }
+
+  r->sq_tail = ___CAST(unsigned*, ___CAST(char*,r->sq_ring) + p.sq_off.tail);
+  r->sq_mask = ___CAST(unsigned*, ___CAST(char*,r->sq_ring) + p.sq_off.ring_mask);
+  r->sq_array = ___CAST(unsigned*, ___CAST(char*,r->sq_ring) + p.sq_off.array);
+  r->cq_head = ___CAST(unsigned*, ___CAST(char*,r->cq_ring) + p.cq_off.head);
+  r->cq_tail = ___CAST(unsigned*, ___CAST(char*,r->cq_ring) + p.cq_off.tail);
+  r->cq_mask = ___CAST(unsigned*, ___CAST(char*,r->cq_ring) + p.cq_off.ring_mask);
+  r->cqes = ___CAST(struct io_uring_cqe*,
+                    ___CAST(char*,r->cq_ring) + p.cq_off.cqes);
+
+  r->pending = 0;
+  r->result = 0;
+  r->lo = 0;
+  r->hi = 0;
+
+  return r;
 }
 
-#endif
 
-___HIDDEN ___SCMOBJ ___device_file_close_raw_virt
-   ___P((___device_stream *self,
-         int direction),
-        (self,
-         direction)
-___device_stream *self;
-int direction;)
+___HIDDEN ___BOOL ___io_uring_reap
+   ___P((___io_uring *r,
+         ___BOOL wait),
+        (r,
+         wait)
+___io_uring *r;
+___BOOL wait;)
 {
-  ___device_file *d = ___CAST(___device_file*,self);
-  int is_not_closed = 0;
+  for (;;)
+    {
+      unsigned head = *r->cq_head;
 
-  if (d->base.base.read_stage != ___STAGE_CLOSED)
-    is_not_closed |= ___DIRECTION_RD;
+      if (head != __atomic_load_n (r->cq_tail, __ATOMIC_ACQUIRE))
+        {
+          r->result = r->cqes[head & *r->cq_mask].res;
+          __atomic_store_n (r->cq_head, head+1, __ATOMIC_RELEASE);
+          r->pending = 0;
+          if (r->result > 0)
+            {
+              r->lo = 0;
+              r->hi = r->result;
+            }
+          return 1;
+        }
 
-  if (d->base.base.write_stage != ___STAGE_CLOSED)
-    is_not_closed |= ___DIRECTION_WR;
+      if (!wait)
+        return 0;
 
-  if (is_not_closed == 0)
-    return ___FIX(___NO_ERR);
+      if (syscall (__NR_io_uring_enter, r->fd, 0, 1,
+                   IORING_ENTER_GETEVENTS, NULL, 0) < 0 &&
+          errno != EINTR)
+        return 0;
+    }
+}
 
-  if ((is_not_closed & ~direction) == 0)
-    {
-      /* Close file when both sides are closed. */
 
-      d->base.base.read_stage = ___STAGE_CLOSED; /* avoid multiple closes */
-      d->base.base.write_stage = ___STAGE_CLOSED;
+___HIDDEN int ___io_uring_submit_read
+   ___P((___io_uring *r,
+         int fd),
+        (r,
+         fd)
+___io_uring *r;
+int fd;)
+{
+  unsigned tail = *r->sq_tail;
+  unsigned index = tail & *r->sq_mask;
+  struct io_uring_sqe *sqe = &r->sqes[index];
 
-      if ((d->base.base.close_direction & d->base.base.direction)
-          == d->base.base.direction)
-        {
-#if 0
-          ___device_file_restore_initial_mode (d);
-#endif
+  memset (sqe, 0, sizeof (*sqe));
 
-#ifndef USE_POSIX
-#ifndef USE_WIN32
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = fd;
+  sqe->off = ___CAST(___U64,-1); /* read at the file position */
+  sqe->addr = ___CAST(___U64,___CAST(___SIZE_T,r->buf));
+  sqe->len = ___IO_URING_BUF_SIZE;
 
-          if (d->stream != 0)
-            if (___fclose (d->stream) != 0)
-              return err_code_from_errno ();
+  r->sq_array[index] = index;
+  __atomic_store_n (r->sq_tail, tail+1, __ATOMIC_RELEASE);
 
-#endif
-#endif
+  for (;;)
+    {
+      int n = syscall (__NR_io_uring_enter, r->fd, 1, 0, 0, NULL, 0);
 
-#ifdef USE_POSIX
-          if (___close_no_EINTR (d->fd) < 0)
-            return err_code_from_errno ();
-#endif
+      if (n >= 0)
+        break;
 
-#ifdef USE_WIN32
-          if (!CloseHandle (d->h))
-            return err_code_from_GetLastError ();
-#endif
+      if (errno != EINTR)
+        {
+          __atomic_store_n (r->sq_tail, tail, __ATOMIC_RELEASE);
+          return -1;
         }
     }
-  else if (is_not_closed & direction & ___DIRECTION_RD)
-    d->base.base.read_stage = ___STAGE_CLOSED;
-  else if (is_not_closed & direction & ___DIRECTION_WR)
-    d->base.base.write_stage = ___STAGE_CLOSED;
 
-  return ___FIX(___NO_ERR);
+  r->pending = 1;
+
+  return 0;
+}
+
+
+___HIDDEN void ___io_uring_cleanup
+   ___P((___io_uring *r),
+        (r)
+___io_uring *r;)
+{
+  if (r->pending)
+    ___io_uring_reap (r, 1); /* the kernel must be done with buf */
+
+  ___io_uring_unmap (r);
+}
+
+#endif
+
+
+/*---------------------------------------------------------------------------*/
+
+/* Memory-mapped regular files. */
+
+#ifdef USE_mmap
+
+/*
+ * A file device opened for input with the mmap: #t setting maps the
+ * whole file read-only and its reads copy bytes from the mapping
+ * instead of calling read.  The mapping is also shared by windows,
+ * which are foreign objects that give Scheme code access to a range
+ * of the file without copying it to the Scheme heap.  The mapping is
+ * unmapped when the device is closed and the windows on it have been
+ * reclaimed.
+ */
+
+typedef struct ___mmap_region_struct
+  {
+    ___U8 *addr;      /* start of the mapping (NULL for an empty file) */
+    ___SIZE_T len;    /* length of the file when it was mapped */
+    ___WORD refcount; /* the device and each window hold a reference */
+  } ___mmap_region;
+
+typedef struct ___mmap_window_struct
+  {
+    ___mmap_region *region;
+    ___U8 *ptr;
+    ___SIZE_T len;
+  } ___mmap_window;
+
+
+___HIDDEN void ___mmap_region_release
+   ___P((___mmap_region *r),
+        (r)
+___mmap_region *r;)
+{
+  /*
+   * Windows are released by the GC of any processor, so the
+   * reference count is updated atomically.
+   */
+
+  if (___FETCH_AND_ADD_WORD(&r->refcount, -1) == 1)
+    {
+      if (r->addr != NULL)
+        munmap (r->addr, r->len);
+      ___FREE_MEM(r);
+    }
+}
+
+
+___HIDDEN ___mmap_region *___mmap_region_setup
+   ___P((int fd),
+        (fd)
+int fd;)
+{
+  struct stat s;
+  ___mmap_region *r;
+
+  if (fstat (fd, &s) < 0 ||
+      !S_ISREG(s.st_mode) ||
+      s.st_size > ___MAX_FIX) /* window offsets must be fixnums */
+    return NULL;
+
+  r = ___CAST(___mmap_region*, ___ALLOC_MEM(sizeof (___mmap_region)));
+
+  if (r == NULL)
+    return NULL;
+
+  r->addr = NULL;
+  r->len = s.st_size;
+  r->refcount = 1;
+
+  if (r->len > 0)
+    {
+      void *p = mmap (NULL, r->len, PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (p == MAP_FAILED)
+        {
+          ___FREE_MEM(r);
+          return NULL;
+        }
+
+      r->addr = ___CAST(___U8*,p);
+
+#ifdef USE_madvise
+#ifdef MADV_SEQUENTIAL
+
+      madvise (p, r->len, MADV_SEQUENTIAL); /* only advisory */
+
+#endif
+#endif
+    }
+
+  return r;
+}
+
+
+___HIDDEN ___SCMOBJ ___release_mmap_window
+   ___P((void *x),
+        (x)
+void *x;)
+{
+  ___mmap_window *w = ___CAST(___mmap_window*,x);
+
+  ___mmap_region_release (w->region);
+  ___FREE_MEM(w);
+
+  return ___FIX(___NO_ERR);
+}
+
+#endif
+
+
+/*---------------------------------------------------------------------------*/
+
+/* File stream device */
+
+typedef struct ___device_file_struct
+  {
+    ___device_stream base;
+
+#ifndef USE_POSIX
+#ifndef USE_WIN32
+
+    ___FILE *stream;
+
+#endif
+#endif
+
+#ifdef USE_POSIX
+    int fd;
+#ifdef USE_io_uring
+    ___io_uring *uring; /* NULL when reading with read */
+#endif
+#ifdef USE_mmap
+    ___mmap_region *map; /* NULL when the file is not mapped */
+    ___SIZE_T map_pos;   /* offset of the next byte to read in map */
+#endif
+#endif
+
+#ifdef USE_WIN32
+    HANDLE h;
+    int flags;
+#endif
+  } ___device_file;
+
+typedef struct ___device_file_vtbl_struct
+  {
+    ___device_stream_vtbl base;
+  } ___device_file_vtbl;
+
+___HIDDEN int ___device_file_kind
+   ___P((___device *self),
+        (self)
+___device *self;)
+{
+  return ___FILE_DEVICE_KIND;
+}
+
+#if 0
+
+___HIDDEN void ___device_file_restore_initial_mode
+   ___P((___device_file *d),
+        (d)
+___device_file *d;)
+{
+#ifdef USE_POSIX
+
+  /* set blocking mode */
+
+  ___set_fd_blocking_mode (d->fd, 1); /* ignore error */
+
+#endif
+}
+
+#endif
+
+___HIDDEN ___SCMOBJ ___device_file_close_raw_virt
+   ___P((___device_stream *self,
+         int direction),
+        (self,
+         direction)
+___device_stream *self;
+int direction;)
+{
+  ___device_file *d = ___CAST(___device_file*,self);
+  int is_not_closed = 0;
+
+  if (d->base.base.read_stage != ___STAGE_CLOSED)
+    is_not_closed |= ___DIRECTION_RD;
+
+  if (d->base.base.write_stage != ___STAGE_CLOSED)
+    is_not_closed |= ___DIRECTION_WR;
+
+  if (is_not_closed == 0)
+    return ___FIX(___NO_ERR);
+
+  if ((is_not_closed & ~direction) == 0)
+    {
+      /* Close file when both sides are closed. */
+
+      d->base.base.read_stage = ___STAGE_CLOSED; /* avoid multiple closes */
+      d->base.base.write_stage = ___STAGE_CLOSED;
+
+      if ((d->base.base.close_direction & d->base.base.direction)
+          == d->base.base.direction)
+        {
+#if 0
+          ___device_file_restore_initial_mode (d);
+#endif
+
+#ifndef USE_POSIX
+#ifndef USE_WIN32
+
+          if (d->stream != 0)
+            if (___fclose (d->stream) != 0)
+              return err_code_from_errno ();
+
+#endif
+#endif
+
+#ifdef USE_POSIX
+#ifdef USE_io_uring
+          if (d->uring != NULL)
+            {
+              ___io_uring_cleanup (d->uring);
+              d->uring = NULL;
+            }
+#endif
+#ifdef USE_mmap
+          if (d->map != NULL)
+            {
+              ___mmap_region_release (d->map);
+              d->map = NULL;
+            }
+#endif
+#ifdef USE_epoll
+          ___device_select_forget_fd (d->fd);
+#endif
+          if (___close_no_EINTR (d->fd) < 0)
+            return err_code_from_errno ();
+#endif
+
+#ifdef USE_WIN32
+          if (!CloseHandle (d->h))
+            return err_code_from_GetLastError ();
+#endif
+        }
+    }
+  else if (is_not_closed & direction & ___DIRECTION_RD)
+    d->base.base.read_stage = ___STAGE_CLOSED;
+  else if (is_not_closed & direction & ___DIRECTION_WR)
+    d->base.base.write_stage = ___STAGE_CLOSED;
+
+  return ___FIX(___NO_ERR);
 }
 
 ___HIDDEN ___SCMOBJ ___device_file_select_raw_virt
@@ -7306,6 +7938,13 @@ ___device_select_state *state;)
 #endif
 
 #ifdef USE_POSIX
+#ifdef USE_io_uring
+          if (for_op == FOR_READING &&
+              d->uring != NULL &&
+              d->uring->pending)
+            ___device_select_add_fd (state, d->uring->fd, for_op);
+          else
+#endif
           ___device_select_add_fd (state, d->fd, for_op);
 #endif
         }
@@ -7328,6 +7967,16 @@ ___device_select_state *state;)
 
 #ifdef USE_POSIX
 
+#ifdef USE_io_uring
+      if (for_op == FOR_READING &&
+          d->uring != NULL &&
+          d->uring->pending)
+        {
+          if (___FD_ISSET(d->uring->fd, state->readfds))
+            state->devs[i] = NULL;
+        }
+      else
+#endif
       if (for_op == FOR_READING
            ? ___FD_ISSET(d->fd, state->readfds)
            : ___FD_ISSET(d->fd, state->writefds))
@@ -7461,6 +8110,52 @@ int whence;)
 
       ___stream_index new_pos;
 
+#ifdef USE_mmap
+
+      if (d->map != NULL)
+        {
+          if (whence == SEEK_SET)
+            new_pos = *pos;
+          else if (whence == SEEK_CUR)
+            new_pos = ___CAST(___stream_index,d->map_pos) + *pos;
+          else
+            new_pos = ___CAST(___stream_index,d->map->len) + *pos;
+
+          if (new_pos < 0)
+            return ___FIX(___ERRNO_ERR(EINVAL));
+
+          d->map_pos = new_pos;
+          *pos = new_pos;
+
+          return ___FIX(___NO_ERR);
+        }
+
+#endif
+
+#ifdef USE_io_uring
+
+      if (d->uring != NULL)
+        {
+          /*
+           * Move the file position back to the first byte that was
+           * read ahead but not consumed.
+           */
+
+          ___io_uring *r = d->uring;
+
+          if (r->pending)
+            ___io_uring_reap (r, 1);
+
+          if (r->lo < r->hi)
+            {
+              if (lseek (d->fd, r->lo - r->hi, SEEK_CUR) < 0)
+                return err_code_from_errno ();
+              r->lo = r->hi = 0;
+            }
+        }
+
+#endif
+
       if ((new_pos = lseek (d->fd, *pos, whence)) < 0)
         return err_code_from_errno ();
 
@@ -7541,6 +8236,76 @@ ___stream_index *len_done;)
 
 #ifdef USE_POSIX
 
+#ifdef USE_mmap
+
+  if (d->map != NULL)
+    {
+      ___mmap_region *r = d->map;
+
+      if (d->map_pos >= r->len)
+        len = 0; /* end of file */
+      else if (___CAST(___SIZE_T,len) > r->len - d->map_pos)
+        len = r->len - d->map_pos;
+
+      if (len > 0)
+        {
+          memmove (buf, r->addr + d->map_pos, len);
+          d->map_pos += len;
+        }
+
+      *len_done = len;
+
+      return ___FIX(___NO_ERR);
+    }
+
+#endif
+
+#ifdef USE_io_uring
+
+  if (d->uring != NULL)
+    {
+      ___io_uring *r = d->uring;
+
+      if (r->lo == r->hi)
+        {
+          if (!r->pending && ___io_uring_submit_read (r, d->fd) < 0)
+            goto fallback;
+
+          if (!___io_uring_reap (r, 0))
+            return ___FIX(___ERRNO_ERR(EAGAIN));
+
+          if (r->result < 0)
+            {
+              if (r->result == -EINVAL || r->result == -EOPNOTSUPP)
+                goto fallback; /* kernel does not support IORING_OP_READ */
+              return ___FIX(___ERRNO_ERR(-r->result));
+            }
+
+          if (r->result == 0)
+            {
+              *len_done = 0; /* end of file */
+              return ___FIX(___NO_ERR);
+            }
+        }
+
+      if (len > r->hi - r->lo)
+        len = r->hi - r->lo;
+
+      memmove (buf, r->buf + r->lo, len);
+      r->lo += len;
+
+      *len_done = len;
+
+      return ___FIX(___NO_ERR);
+
+    fallback:
+
+      ___io_uring_cleanup (r);
+      d->uring = NULL;
+    }
+
+#endif
+
   {
     int n;
 
@@ -7819,6 +8584,22 @@ int io_settings;)
   d->base.base.vtbl = &___device_file_table;
   d->fd = fd;
 
+#ifdef USE_mmap
+
+  d->map = NULL;
+  d->map_pos = 0;
+
+#endif
+
+#ifdef USE_io_uring
+
+  d->uring = NULL;
+
+  if (___GSTATE->setup_params.io_uring && direction == ___DIRECTION_RD)
+    d->uring = ___io_uring_setup (fd); /* NULL if not possible */
+
+#endif
+
   *dev = d;
 
   return ___device_stream_setup
@@ -9845,6 +10626,451 @@ ___SCMOBJ hi;)
 }
 
 
+#ifdef USE_POSIX
+#if defined (USE_sendfile) || defined (USE_splice_syscall)
+
+/*
+ * ___device_stream_copy_fd returns the file descriptor that
+ * ___os_device_stream_copy can use to transfer data directly in the
+ * given direction of a device, or -1 when the data must go through
+ * the device's read and write operations.
+ */
+
+___HIDDEN int ___device_stream_copy_fd
+   ___P((___device_stream *d,
+         int for_writing),
+        (d,
+         for_writing)
+___device_stream *d;
+int for_writing;)
+{
+  if ((for_writing ? d->base.write_stage : d->base.read_stage)
+      != ___STAGE_OPEN)
+    return -1;
+
+  switch (___device_kind (&d->base))
+    {
+    case ___FILE_DEVICE_KIND:
+      {
+        ___device_file *dev = ___CAST(___device_file*,d);
+#ifdef USE_io_uring
+        if (dev->uring != NULL)
+          return -1; /* the ring may hold bytes that were read ahead */
+#endif
+#ifdef USE_mmap
+        if (dev->map != NULL)
+          return -1; /* the fd's position is not the device's position */
+#endif
+        return dev->fd;
+      }
+
+    case ___PIPE_DEVICE_KIND:
+    case ___PROCESS_DEVICE_KIND:
+      {
+        ___device_pipe *dev = ___CAST(___device_pipe*,d);
+        if (dev->poll_interval_nsecs > 0)
+          return -1;
+        return for_writing ? dev->fd_wr : dev->fd_rd;
+      }
+
+#ifdef USE_NETWORKING
+
+    case ___TCP_CLIENT_DEVICE_KIND:
+      {
+        ___device_tcp_client *dev = ___CAST(___device_tcp_client*,d);
+#ifdef USE_OPENSSL
+        if (dev->tls != NULL)
+          return -1;
+#endif
+        if (dev->try_connect_again != 0)
+          return -1;
+        return dev->s;
+      }
+
+#endif
+    }
+
+  return -1;
+}
+
+#endif
+#endif
+
+
+#ifdef USE_splice_syscall
+
+/* These are only declared by <fcntl.h> when _GNU_SOURCE is defined */
+
+#ifndef SPLICE_F_MOVE
+#define SPLICE_F_MOVE 1
+#endif
+
+#ifndef SPLICE_F_NONBLOCK
+#define SPLICE_F_NONBLOCK 2
+#endif
+
+#endif
+
+
+/*
+ * ___os_device_stream_copy transfers up to len bytes from the
+ * device of rdev_condvar to the device of wdev_condvar without
+ * copying them to a user space buffer.  It returns the number of
+ * bytes transferred (0 at end of file), #f when the input device has
+ * no data available, the EAGAIN error code when the output device
+ * can't accept data, and the "unimplemented" error code when the
+ * devices don't allow a direct transfer, in which case the caller
+ * must transfer the data through the ports.
+ */
+
+___SCMOBJ ___os_device_stream_copy
+   ___P((___SCMOBJ rdev_condvar,
+         ___SCMOBJ wdev_condvar,
+         ___SCMOBJ len),
+        (rdev_condvar,
+         wdev_condvar,
+         len)
+___SCMOBJ rdev_condvar;
+___SCMOBJ wdev_condvar;
+___SCMOBJ len;)
+{
+#ifdef USE_POSIX
+#if defined (USE_sendfile) || defined (USE_splice_syscall)
+
+  ___device_stream *rd =
+    ___CAST(___device_stream*,
+            ___FOREIGN_PTR_FIELD(___CONDVAR_NAME_FIELD(rdev_condvar)));
+  ___device_stream *wd =
+    ___CAST(___device_stream*,
+            ___FOREIGN_PTR_FIELD(___CONDVAR_NAME_FIELD(wdev_condvar)));
+  int in_fd = ___device_stream_copy_fd (rd, 0);
+  int out_fd = ___device_stream_copy_fd (wd, 1);
+  size_t n = ___INT(len);
+  ssize_t result = -1;
+
+  if (in_fd < 0 || out_fd < 0)
+    return ___FIX(___UNIMPL_ERR);
+
+  errno = EINVAL;
+
+#ifdef USE_sendfile
+
+  /* sendfile reads from regular files and writes to any descriptor */
+
+  result = sendfile (out_fd, in_fd, NULL, n);
+
+#endif
+
+#ifdef USE_splice_syscall
+
+  /* splice needs a pipe at one end and accepts any other descriptor */
+
+  if (result < 0 && (errno == EINVAL || errno == ENOSYS))
+    result = syscall (SYS_splice,
+                      in_fd,
+                      NULL,
+                      out_fd,
+                      NULL,
+                      n,
+                      SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+#endif
+
+  if (result >= 0)
+    return ___FIX(result);
+
+  if (errno == EINVAL || errno == ENOSYS)
+    return ___FIX(___UNIMPL_ERR);
+
+  if (errno == EAGAIN)
+    {
+      int avail;
+
+      /*
+       * The input of sendfile is always ready, and the input of
+       * splice is a pipe or a socket, so it is the input that is not
+       * ready when no bytes are waiting to be read.
+       */
+
+      if (ioctl (in_fd, FIONREAD, &avail) == 0 && avail == 0)
+        return ___FAL;
+    }
+
+  return err_code_from_errno ();
+
+#else
+
+  return ___FIX(___UNIMPL_ERR);
+
+#endif
+#else
+
+  return ___FIX(___UNIMPL_ERR);
+
+#endif
+}
+
+
+___SCMOBJ ___os_device_stream_mmap
+   ___P((___SCMOBJ dev),
+        (dev)
+___SCMOBJ dev;)
+{
+#ifdef USE_mmap
+
+  ___device_stream *d =
+    ___CAST(___device_stream*,___FOREIGN_PTR_FIELD(dev));
+  ___device_file *f = ___CAST(___device_file*,d);
+  ___stream_index pos;
+
+  if (___device_kind (&d->base) != ___FILE_DEVICE_KIND ||
+      d->base.direction != ___DIRECTION_RD)
+    return ___FIX(___UNIMPL_ERR);
+
+  if (d->base.read_stage != ___STAGE_OPEN)
+    return ___FIX(___CLOSED_DEVICE_ERR);
+
+  if (f->map != NULL)
+    return ___FIX(___NO_ERR);
+
+#ifdef USE_io_uring
+
+  if (f->uring != NULL)
+    {
+      ___io_uring *r = f->uring;
+
+      if (r->pending || r->lo < r->hi) /* bytes were read ahead? */
+        return ___FIX(___UNIMPL_ERR);
+
+      ___io_uring_cleanup (r);
+      f->uring = NULL;
+    }
+
+#endif
+
+  if ((pos = lseek (f->fd, 0, SEEK_CUR)) < 0)
+    return err_code_from_errno ();
+
+  if ((f->map = ___mmap_region_setup (f->fd)) == NULL)
+    return ___FIX(___UNIMPL_ERR);
+
+  f->map_pos = pos;
+
+  return ___FIX(___NO_ERR);
+
+#else
+
+  return ___FIX(___UNIMPL_ERR);
+
+#endif
+}
+
+
+___SCMOBJ ___os_device_stream_mmap_length
+   ___P((___SCMOBJ dev),
+        (dev)
+___SCMOBJ dev;)
+{
+#ifdef USE_mmap
+
+  ___device_stream *d =
+    ___CAST(___device_stream*,___FOREIGN_PTR_FIELD(dev));
+
+  if (___device_kind (&d->base) == ___FILE_DEVICE_KIND)
+    {
+      ___device_file *f = ___CAST(___device_file*,d);
+
+      if (f->map != NULL)
+        return ___FIX(f->map->len);
+    }
+
+#endif
+
+  return ___FAL;
+}
+
+
+___SCMOBJ ___os_device_stream_mmap_window
+   ___P((___SCMOBJ dev,
+         ___SCMOBJ start,
+         ___SCMOBJ end,
+         ___SCMOBJ tags),
+        (dev,
+         start,
+         end,
+         tags)
+___SCMOBJ dev;
+___SCMOBJ start;
+___SCMOBJ end;
+___SCMOBJ tags;)
+{
+#ifdef USE_mmap
+
+  ___device_file *f =
+    ___CAST(___device_file*,___FOREIGN_PTR_FIELD(dev));
+  ___mmap_window *w;
+  ___SCMOBJ e;
+  ___SCMOBJ result;
+
+  /*
+   * The caller holds the port's mutex and checked that the range is
+   * valid for the mapping, but the device may have been closed since.
+   */
+
+  if (f->map == NULL)
+    return ___FIX(___CLOSED_DEVICE_ERR);
+
+  w = ___CAST(___mmap_window*, ___ALLOC_MEM(sizeof (___mmap_window)));
+
+  if (w == NULL)
+    return ___FIX(___HEAP_OVERFLOW_ERR);
+
+  w->region = f->map;
+  w->ptr = f->map->addr + ___INT(start);
+  w->len = ___INT(end) - ___INT(start);
+
+  ___FETCH_AND_ADD_WORD(&f->map->refcount, 1);
+
+  if ((e = ___NONNULLPOINTER_to_SCMOBJ
+             (___PSTATE,
+              ___CAST(void*,w),
+              tags,
+              ___release_mmap_window,
+              &result,
+              ___RETURN_POS))
+      != ___FIX(___NO_ERR))
+    {
+      ___release_mmap_window (w);
+      return e;
+    }
+
+  return ___release_scmobj (result);
+
+#else
+
+  return ___FIX(___UNIMPL_ERR);
+
+#endif
+}
+
+
+/*
+ * Operations on windows.  The caller checks the indices, which are
+ * relative to the start of the window.
+ */
+
+___SCMOBJ ___os_mmap_window_length
+   ___P((___SCMOBJ window),
+        (window)
+___SCMOBJ window;)
+{
+#ifdef USE_mmap
+
+  ___mmap_window *w =
+    ___CAST(___mmap_window*,___FOREIGN_PTR_FIELD(window));
+
+  return ___FIX(w->len);
+
+#else
+
+  return ___FIX(0);
+
+#endif
+}
+
+
+___SCMOBJ ___os_mmap_window_ref
+   ___P((___SCMOBJ window,
+         ___SCMOBJ i),
+        (window,
+         i)
+___SCMOBJ window;
+___SCMOBJ i;)
+{
+#ifdef USE_mmap
+
+  ___mmap_window *w =
+    ___CAST(___mmap_window*,___FOREIGN_PTR_FIELD(window));
+
+  return ___FIX(w->ptr[___INT(i)]);
+
+#else
+
+  return ___FIX(0);
+
+#endif
+}
+
+
+___SCMOBJ ___os_mmap_window_index
+   ___P((___SCMOBJ window,
+         ___SCMOBJ byte,
+         ___SCMOBJ start,
+         ___SCMOBJ end),
+        (window,
+         byte,
+         start,
+         end)
+___SCMOBJ window;
+___SCMOBJ byte;
+___SCMOBJ start;
+___SCMOBJ end;)
+{
+#ifdef USE_mmap
+
+  ___mmap_window *w =
+    ___CAST(___mmap_window*,___FOREIGN_PTR_FIELD(window));
+
+  if (___INT(start) < ___INT(end))
+    {
+      ___U8 *p = ___CAST(___U8*,
+                         memchr (w->ptr + ___INT(start),
+                                 ___INT(byte),
+                                 ___INT(end) - ___INT(start)));
+
+      if (p != NULL)
+        return ___FIX(p - w->ptr);
+    }
+
+#endif
+
+  return ___FAL;
+}
+
+
+___SCMOBJ ___os_mmap_window_copy
+   ___P((___SCMOBJ window,
+         ___SCMOBJ start,
+         ___SCMOBJ end,
+         ___SCMOBJ u8vect,
+         ___SCMOBJ at),
+        (window,
+         start,
+         end,
+         u8vect,
+         at)
+___SCMOBJ window;
+___SCMOBJ start;
+___SCMOBJ end;
+___SCMOBJ u8vect;
+___SCMOBJ at;)
+{
+#ifdef USE_mmap
+
+  ___mmap_window *w =
+    ___CAST(___mmap_window*,___FOREIGN_PTR_FIELD(window));
+
+  if (___INT(start) < ___INT(end))
+    memmove (___CAST(___U8*,___BODY_AS(u8vect,___tU8VECTOR)) + ___INT(at),
+             w->ptr + ___INT(start),
+             ___INT(end) - ___INT(start));
+
+#endif
+
+  return ___VOID;
+}
+
+
 ___SCMOBJ ___os_device_stream_width
    ___P((___SCMOBJ dev_condvar),
         (dev_condvar)
@@ -9943,6 +11169,9 @@ ___HIDDEN ___SCMOBJ ___device_raw_close_virt
       d->base.write_stage = ___STAGE_CLOSED;
 
 #ifdef USE_POSIX
+#ifdef USE_epoll
+      ___device_select_forget_fd (d->fd);
+#endif
       if (___close_no_EINTR (d->fd) < 0)
         return err_code_from_errno ();
 #endif
@@ -11773,6 +13002,13 @@ ___processor_state ___ps;)
 
 #endif
 
+#ifdef USE_epoll
+
+  if ((___ps->os.epoll_fd = epoll_create1 (EPOLL_CLOEXEC)) < 0)
+    return err_code_from_errno ();
+
+#endif
+
 #ifdef USE_ASYNC_DEVICE_SELECT_ABORT
 
 #ifdef USE_POSIX
@@ -11824,6 +13060,12 @@ ___processor_state ___ps;)
 
 #endif
 
+#endif
+
+#ifdef USE_epoll
+
+  ___close_no_EINTR (___ps->os.epoll_fd); /* ignore error */
+
 #endif
 }
 
@@ -11841,6 +13083,7 @@ ___virtual_machine_state ___vms;)
 
     ___vms->os.fdset.size = size;
     ___vms->os.fdset.overflow = 0;
+    ___vms->os.fdset.forget_count = 0;
   }
 #endif
 
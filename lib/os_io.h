@@ -140,6 +140,15 @@ typedef struct ___device_select_state_struct
     ___fdbits *writefds;
 #endif
 
+#ifdef USE_epoll
+    int epoll_fd;
+    ___U8 *armed; /* events armed on each fd, kept from one select to the next */
+    int fd_count;
+    /* active set bitmaps */
+    ___fdbits *readfds;
+    ___fdbits *writefds;
+#endif
+
 #endif
 
 #ifdef USE_MsgWaitForMultipleObjects
@@ -650,6 +659,14 @@ extern void ___device_select_abort
    ___P((___processor_state ___ps),
         ());
 
+#ifdef USE_epoll
+
+extern void ___device_select_forget_fd
+   ___P((int fd),
+        ());
+
+#endif
+
 extern ___SCMOBJ ___device_force_output
    ___P((___device *self,
          int level),
@@ -711,6 +728,51 @@ extern ___SCMOBJ ___os_device_stream_write
          ___SCMOBJ hi),
         ());
 
+extern ___SCMOBJ ___os_device_stream_copy
+   ___P((___SCMOBJ rdev_condvar,
+         ___SCMOBJ wdev_condvar,
+         ___SCMOBJ len),
+        ());
+
+extern ___SCMOBJ ___os_device_stream_mmap
+   ___P((___SCMOBJ dev),
+        ());
+
+extern ___SCMOBJ ___os_device_stream_mmap_length
+   ___P((___SCMOBJ dev),
+        ());
+
+extern ___SCMOBJ ___os_device_stream_mmap_window
+   ___P((___SCMOBJ dev,
+         ___SCMOBJ start,
+         ___SCMOBJ end,
+         ___SCMOBJ tags),
+        ());
+
+extern ___SCMOBJ ___os_mmap_window_length
+   ___P((___SCMOBJ window),
+        ());
+
+extern ___SCMOBJ ___os_mmap_window_ref
+   ___P((___SCMOBJ window,
+         ___SCMOBJ i),
+        ());
+
+extern ___SCMOBJ ___os_mmap_window_index
+   ___P((___SCMOBJ window,
+         ___SCMOBJ byte,
+         ___SCMOBJ start,
+         ___SCMOBJ end),
+        ());
+
+extern ___SCMOBJ ___os_mmap_window_copy
+   ___P((___SCMOBJ window,
+         ___SCMOBJ start,
+         ___SCMOBJ end,
+         ___SCMOBJ u8vect,
+         ___SCMOBJ at),
+        ());
+
 extern ___SCMOBJ ___os_device_stream_width
    ___P((___SCMOBJ dev_condvar),
         ());
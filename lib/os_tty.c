@@ -8184,6 +8184,9 @@ ___device_tty *self;)
           == d->base.base.direction)
         {
 #ifdef USE_POSIX
+#ifdef USE_epoll
+          ___device_select_forget_fd (d->fd);
+#endif
           if (d->fd >= 0 && ___close_no_EINTR (d->fd) < 0)
             return err_code_from_errno ();
 #endif
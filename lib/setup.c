@@ -937,6 +937,8 @@ ___WORD target_processor_count;)
     {
       int i;
 
+      ___ACTLOG_BEGIN_PS(vm_resize,orange);
+
       /* Setup processor state of each additional processor */
 
       for (i=initial; i<target_processor_count; i++)
@@ -951,6 +953,8 @@ ___WORD target_processor_count;)
 
               BARRIER();
 
+              ___ACTLOG_END_PS();
+
               return err;
             }
         }
@@ -1001,6 +1005,8 @@ ___WORD target_processor_count;)
                 }
             }
         }
+
+      ___ACTLOG_END_PS();
     }
 
 #endif
@@ -3097,18 +3103,25 @@ double x;)
  */
 
 ___HIDDEN void init_symkey_glo1
-   ___P((___mod_or_lnk mol),
-        (mol)
-___mod_or_lnk mol;)
+   ___P((___mod_or_lnk mol,
+         ___SIZE_TS *nb_symbols,
+         ___SIZE_TS *nb_keywords),
+        (mol,
+         nb_symbols,
+         nb_keywords)
+___mod_or_lnk mol;
+___SIZE_TS *nb_symbols;
+___SIZE_TS *nb_keywords;)
 {
   if (mol->module.kind == ___LINKFILE_KIND)
     {
       ___linkinfo *p1 = mol->linkfile.linkertbl;
       ___FAKEWORD *p2 = mol->linkfile.sym_list;
+      ___FAKEWORD *p3 = mol->linkfile.key_list;
 
       while (p1->mol != 0)
         {
-          init_symkey_glo1 (p1->mol);
+          init_symkey_glo1 (p1->mol, nb_symbols, nb_keywords);
           p1++;
         }
 
@@ -3123,6 +3136,15 @@ ___mod_or_lnk mol;)
           glo = ___CAST(___glo_struct*,sym_ptr[___SUBTYPED_BODY+___SYMBOL_GLOBAL]);
 
           sym_ptr[___SUBTYPED_BODY+___SYMKEY_HASH] = glo->prm; /* move symbol's hash value */
+
+          (*nb_symbols)++;
+        }
+
+      while (p3 != 0)
+        {
+          p3 = ___CAST(___FAKEWORD*,___CAST(___SCMOBJ*,p3)[0]);
+
+          (*nb_keywords)++;
         }
     }
 }
@@ -4905,12 +4927,16 @@ ___setup_params_struct *setup_params;)
   setup_params->argv                = setup_params->reset_argv;
   setup_params->min_heap            = 0;
   setup_params->max_heap            = 0;
+  setup_params->max_heap_soft       = 0;
   setup_params->live_percent        = 0;
 #ifdef ___SINGLE_THREADED_VMS
   setup_params->parallelism_level   = 1;
 #else
   setup_params->parallelism_level   = 0;
 #endif
+  setup_params->parallelism_max     = 0;
+  setup_params->gc_settings         = 0;
+  setup_params->io_uring            = 0;
   setup_params->adjust_heap_hook    = 0;
   setup_params->display_error       = 0;
   setup_params->fatal_error         = 0;
@@ -6342,7 +6368,22 @@ ___setup_params_struct *setup_params;)
    * and primitives.
    */
 
-  init_symkey_glo1 (mol);
+  {
+    ___SIZE_TS nb_symbols = 0;
+    ___SIZE_TS nb_keywords = 0;
+
+    init_symkey_glo1 (mol, &nb_symbols, &nb_keywords);
+
+    /*
+     * Size the symbol and keyword tables for all the symbols and
+     * keywords of the program so that they are interned without
+     * rehashing.
+     */
+
+    ___reserve_symkey_table (___sSYMBOL, nb_symbols);
+    ___reserve_symkey_table (___sKEYWORD, nb_keywords);
+  }
+
   init_symkey_glo2 (mol);
 
   do
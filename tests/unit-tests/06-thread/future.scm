@@ -0,0 +1,87 @@
+(include "#.scm")
+
+(define (catch thunk)
+  (with-exception-catcher (lambda (e) e) thunk))
+
+;; a future touched before its task has started is evaluated once
+
+(define count 0)
+
+(define (count!)
+  (set! count (+ count 1))
+  count)
+
+(define f1 (future (count!)))
+
+(check-true (promise? f1))
+(check-equal? (touch f1) 1)
+(check-equal? (touch f1) 1)
+(check-equal? count 1)
+
+;; a future whose task has started is waited for
+
+(define started #f)
+
+(define f2
+  (future
+   (begin
+     (set! started #t)
+     'done)))
+
+(let loop ()
+  (if (not started)
+      (begin
+        (thread-yield!)
+        (loop))))
+
+(check-equal? (touch f2) 'done)
+(check-equal? (touch f2) 'done)
+
+;; an exception raised by the body is raised again by touch
+
+(check-equal? (catch (lambda () (touch (future (raise 'oops))))) 'oops)
+
+(check-equal?
+ (catch (lambda ()
+          (let ((f (future (raise 'oops))))
+            (thread-sleep! 0.01)
+            (touch f))))
+ 'oops)
+
+(check-exn type-exception? (lambda () (touch (future (car 1)))))
+
+;; a body that escapes from a touch is evaluated again by the next
+;; touch (when the task has already run it, every touch returns the
+;; result of the task)
+
+(define main (current-thread))
+(define touching #f)
+(define attempts 0)
+
+(define (flaky)
+  (set! attempts (+ attempts 1))
+  (if (and touching
+           (eq? (current-thread) main)
+           (= attempts 1))
+      (raise 'escaped)
+      attempts))
+
+(define f3 (future (flaky)))
+
+(set! touching #t)
+
+(define first-touch (catch (lambda () (touch f3))))
+
+(define second-touch (touch f3))
+
+(check-equal? second-touch attempts)
+(check-equal? attempts (if (eq? first-touch 'escaped) 2 1))
+(check-true (or (eq? first-touch 'escaped) (eqv? first-touch second-touch)))
+(check-equal? (touch f3) second-touch)
+
+;; touch of a non-promise is the identity
+
+(check-equal? (touch 42) 42)
+
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (touch)))
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (touch 1 2)))
@@ -0,0 +1,26 @@
+(include "#.scm")
+
+(define rw1 (make-rwlock))
+
+(define rw2 (make-rwlock 'rw2))
+
+(check-true (rwlock? rw1))
+(check-true (rwlock? rw2))
+(check-false (rwlock? (make-mutex)))
+(check-false (rwlock? #f))
+
+(check-equal? (rwlock-name rw1) (void))
+(check-equal? (rwlock-name rw2) 'rw2)
+
+(check-equal? (rwlock-specific rw1) (void))
+(check-equal? (rwlock-specific-set! rw1 111) (void))
+(check-equal? (rwlock-specific rw1) 111)
+
+(check-tail-exn type-exception? (lambda () (rwlock-name #f)))
+(check-tail-exn type-exception? (lambda () (rwlock-specific (make-mutex))))
+(check-tail-exn type-exception? (lambda () (rwlock-specific-set! #f #f)))
+
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (make-rwlock #f #f)))
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (rwlock?)))
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (rwlock-name)))
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (rwlock-specific-set! rw1)))
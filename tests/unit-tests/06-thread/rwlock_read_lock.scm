@@ -0,0 +1,43 @@
+(include "#.scm")
+
+(define rw (make-rwlock))
+
+;; several holds for reading can coexist
+
+(check-equal? (rwlock-read-lock! rw) #t)
+(check-equal? (rwlock-read-lock! rw #f) #t)
+(check-equal? (rwlock-read-lock! rw 0) #t)
+
+(check-equal?
+ (thread-join! (thread-start! (make-thread (lambda () (rwlock-read-lock! rw 0)))))
+ #t)
+
+(rwlock-read-unlock! rw)
+(rwlock-read-unlock! rw)
+(rwlock-read-unlock! rw)
+(rwlock-read-unlock! rw)
+
+;; a hold for writing excludes readers until it is released
+
+(check-equal? (rwlock-write-lock! rw) #t)
+
+(check-equal? (rwlock-read-lock! rw -1) #f)
+(check-equal? (rwlock-read-lock! rw 0.01) #f)
+
+(define reader
+  (thread-start! (make-thread (lambda () (rwlock-read-lock! rw 10)))))
+
+(thread-sleep! 0.01)
+
+(rwlock-write-unlock! rw)
+
+(check-equal? (thread-join! reader) #t)
+
+(rwlock-read-unlock! rw)
+
+(check-tail-exn type-exception? (lambda () (rwlock-read-lock! #f)))
+(check-tail-exn type-exception? (lambda () (rwlock-read-lock! (make-mutex))))
+(check-tail-exn type-exception? (lambda () (rwlock-read-lock! rw 'foo)))
+
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (rwlock-read-lock!)))
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (rwlock-read-lock! rw #f #f)))
@@ -0,0 +1,36 @@
+(include "#.scm")
+
+(define rw (make-rwlock))
+
+(check-equal? (rwlock-read-lock! rw) #t)
+(check-equal? (rwlock-read-lock! rw) #t)
+
+(check-equal? (rwlock-read-unlock! rw) (void))
+
+(check-equal? (rwlock-write-lock! rw 0) #f) ;; still held by one reader
+
+(check-equal? (rwlock-read-unlock! rw) (void))
+
+(check-equal? (rwlock-write-lock! rw 0) #t)
+
+;; a hold for writing is not released by rwlock-read-unlock!
+
+(check-exn error-exception? (lambda () (rwlock-read-unlock! rw)))
+
+(check-equal? (rwlock-read-lock! rw 0) #f)
+
+(rwlock-write-unlock! rw)
+
+;; unlocking a free lock is an error and leaves the lock free
+
+(check-exn error-exception? (lambda () (rwlock-read-unlock! rw)))
+
+(check-equal? (rwlock-write-lock! rw 0) #t)
+
+(rwlock-write-unlock! rw)
+
+(check-tail-exn type-exception? (lambda () (rwlock-read-unlock! #f)))
+(check-tail-exn type-exception? (lambda () (rwlock-read-unlock! (make-mutex))))
+
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (rwlock-read-unlock!)))
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (rwlock-read-unlock! rw #f)))
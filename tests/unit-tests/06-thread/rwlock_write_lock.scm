@@ -0,0 +1,59 @@
+(include "#.scm")
+
+(define rw (make-rwlock))
+
+;; a hold for writing excludes all other holds
+
+(check-equal? (rwlock-write-lock! rw) #t)
+
+(check-equal? (rwlock-write-lock! rw -1) #f)
+(check-equal? (rwlock-write-lock! rw 0.01) #f)
+(check-equal? (rwlock-read-lock! rw 0) #f)
+
+(rwlock-write-unlock! rw)
+
+;; readers exclude writers
+
+(check-equal? (rwlock-read-lock! rw #f) #t)
+
+(check-equal? (rwlock-write-lock! rw 0) #f)
+
+;; a waiting writer has precedence over new readers
+
+(define writer
+  (thread-start! (make-thread (lambda () (rwlock-write-lock! rw 10)))))
+
+(thread-sleep! 0.01)
+
+(check-equal? (rwlock-read-lock! rw 0) #f)
+
+(rwlock-read-unlock! rw)
+
+(check-equal? (thread-join! writer) #t)
+
+(rwlock-write-unlock! rw)
+
+;; readers proceed when the waiting writer gives up
+
+(check-equal? (rwlock-read-lock! rw) #t)
+
+(define impatient-writer
+  (thread-start! (make-thread (lambda () (rwlock-write-lock! rw 0.01)))))
+
+(check-equal? (thread-join! impatient-writer) #f)
+
+(check-equal? (rwlock-read-lock! rw 0) #t)
+
+(rwlock-read-unlock! rw)
+(rwlock-read-unlock! rw)
+
+(check-equal? (rwlock-write-lock! rw 0) #t)
+
+(rwlock-write-unlock! rw)
+
+(check-tail-exn type-exception? (lambda () (rwlock-write-lock! #f)))
+(check-tail-exn type-exception? (lambda () (rwlock-write-lock! (make-mutex))))
+(check-tail-exn type-exception? (lambda () (rwlock-write-lock! rw 'foo)))
+
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (rwlock-write-lock!)))
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (rwlock-write-lock! rw #f #f)))
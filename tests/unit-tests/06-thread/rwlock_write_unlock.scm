@@ -0,0 +1,46 @@
+(include "#.scm")
+
+(define rw (make-rwlock))
+
+(check-equal? (rwlock-write-lock! rw) #t)
+
+(check-equal? (rwlock-write-unlock! rw) (void))
+
+(check-equal? (rwlock-read-lock! rw 0) #t)
+
+;; a hold for reading is not released by rwlock-write-unlock!
+
+(check-exn error-exception? (lambda () (rwlock-write-unlock! rw)))
+
+(check-equal? (rwlock-write-lock! rw 0) #f)
+
+(rwlock-read-unlock! rw)
+
+;; unlocking a free lock is an error and leaves the lock free
+
+(check-exn error-exception? (lambda () (rwlock-write-unlock! rw)))
+
+(check-equal? (rwlock-read-lock! rw 0) #t)
+
+(rwlock-read-unlock! rw)
+
+;; a waiting writer is woken up by the release
+
+(check-equal? (rwlock-write-lock! rw) #t)
+
+(define writer
+  (thread-start! (make-thread (lambda () (rwlock-write-lock! rw 10)))))
+
+(thread-sleep! 0.01)
+
+(rwlock-write-unlock! rw)
+
+(check-equal? (thread-join! writer) #t)
+
+(rwlock-write-unlock! rw)
+
+(check-tail-exn type-exception? (lambda () (rwlock-write-unlock! #f)))
+(check-tail-exn type-exception? (lambda () (rwlock-write-unlock! (make-mutex))))
+
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (rwlock-write-unlock!)))
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (rwlock-write-unlock! rw #f)))
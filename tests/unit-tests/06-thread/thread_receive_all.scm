@@ -0,0 +1,47 @@
+(include "#.scm")
+
+;; an empty mailbox gives an empty list, without blocking
+
+(check-equal? (thread-receive-all) '())
+
+;; the messages are returned in the order they were sent
+
+(thread-send (current-thread) 1)
+(thread-send (current-thread) 2)
+(thread-send (current-thread) 3)
+
+(check-equal? (thread-receive-all) '(1 2 3))
+(check-equal? (thread-receive-all) '())
+
+(define receiver (current-thread))
+
+(thread-join!
+ (thread-start!
+  (make-thread
+   (lambda ()
+     (thread-send receiver 'a)
+     (thread-send receiver 'b)))))
+
+(thread-send receiver 'c)
+
+(check-equal? (thread-receive-all) '(a b c))
+
+;; the mailbox cursor is rewound
+
+(thread-send (current-thread) 1)
+(thread-send (current-thread) 2)
+
+(check-equal? (thread-mailbox-next 0 #f) 1)
+(check-equal? (thread-mailbox-next 0 #f) 2)
+(check-equal? (thread-receive-all) '(1 2))
+
+(thread-send (current-thread) 3)
+(thread-send (current-thread) 4)
+
+(check-equal? (thread-mailbox-next 0 #f) 3)
+(check-equal? (thread-mailbox-next 0 #f) 4)
+(check-equal? (thread-mailbox-next 0 #f) #f)
+(check-equal? (thread-receive-all) '(3 4))
+
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (thread-receive-all 0)))
+(check-tail-exn wrong-number-of-arguments-exception? (lambda () (thread-receive-all 0 #f)))
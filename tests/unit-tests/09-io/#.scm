@@ -1 +1,29 @@
 (include "../#.scm")
+
+;; A u8vector of n bytes which are not all the same, for tests that
+;; need more bytes than fit in a port's buffer.
+
+(define (make-test-bytes n)
+  (let ((u8vect (make-u8vector n)))
+    (let loop ((i 0))
+      (if (< i n)
+          (begin
+            (u8vector-set! u8vect i (modulo (* i 7) 256))
+            (loop (+ i 1)))
+          u8vect))))
+
+;; The bytes read from the file opened with the given settings until
+;; the end of file.
+
+(define (read-all-bytes settings)
+  (call-with-input-file settings
+    (lambda (port)
+      (let ((out (open-output-u8vector))
+            (buf (make-u8vector 4096)))
+        (let loop ()
+          (let ((n (read-subu8vector buf 0 (u8vector-length buf) port)))
+            (if (> n 0)
+                (begin
+                  (write-subu8vector buf 0 n out)
+                  (loop))
+                (get-output-u8vector out))))))))
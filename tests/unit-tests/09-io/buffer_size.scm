@@ -0,0 +1,54 @@
+(include "#.scm")
+
+(define file "buffer_size_temp")
+
+(define bytes (make-test-bytes 100000))
+
+(define (write-bytes buffer-size)
+  (call-with-output-file
+      (list path: file buffer-size: buffer-size)
+    (lambda (port)
+      (write-subu8vector bytes 0 (u8vector-length bytes) port))))
+
+(define (read-bytes buffer-size)
+  (read-all-bytes (list path: file buffer-size: buffer-size)))
+
+;; fixed buffer sizes at both bounds, and adaptive buffers
+
+(write-bytes 64)
+(test-equal bytes (read-bytes 64))
+(test-equal bytes (read-bytes 16777216))
+(test-equal bytes (read-bytes 'adaptive))
+
+(write-bytes 'adaptive)
+(test-equal bytes (read-bytes 1000))
+
+;; multi-byte characters straddle the boundaries of the smallest buffers
+
+(define text (make-string 1000 #\x3bb))
+
+(call-with-output-file
+    (list path: file char-encoding: 'UTF-8 buffer-size: 64)
+  (lambda (port) (write-string text port)))
+
+(test-equal
+ text
+ (call-with-input-file
+     (list path: file char-encoding: 'UTF-8 buffer-size: 64)
+   (lambda (port) (read-line port #f))))
+
+;; sizes out of bounds are rejected
+
+(test-error type-exception? (open-input-file (list path: file buffer-size: 63)))
+(test-error type-exception? (open-input-file (list path: file buffer-size: 0)))
+(test-error type-exception? (open-input-file (list path: file buffer-size: -1)))
+(test-error type-exception? (open-input-file (list path: file buffer-size: 16777217)))
+(test-error type-exception? (open-input-file (list path: file buffer-size: 'foo)))
+
+;; buffer-size: can't be changed after the port is created
+
+(let ((port (open-input-file file)))
+  (test-error type-exception? (port-settings-set! port '(buffer-size: 64)))
+  (close-port port))
+
+(delete-file file)
@@ -0,0 +1,64 @@
+(include "#.scm")
+
+(define file "mmap_temp")
+
+(define bytes (make-test-bytes 100000))
+
+;; reads of a mapped file give the same bytes as reads with system calls
+
+(write-file-u8vector file bytes)
+
+(test-equal bytes (read-all-bytes (list path: file mmap: #t)))
+(test-equal bytes (read-all-bytes (list path: file mmap: #f)))
+
+(test-equal
+ (u8vector->list (subu8vector bytes 0 4))
+ (call-with-input-file (list path: file mmap: #t)
+   (lambda (port)
+     (let* ((b0 (read-u8 port))
+            (b1 (read-u8 port))
+            (b2 (read-u8 port))
+            (b3 (read-u8 port)))
+       (list b0 b1 b2 b3)))))
+
+;; the byte position of a mapped file can be changed
+
+(test-equal
+ (u8vector-ref bytes 5000)
+ (call-with-input-file (list path: file mmap: #t)
+   (lambda (port)
+     (input-port-byte-position port 5000)
+     (read-u8 port))))
+
+;; characters are decoded from the mapping
+
+(call-with-output-file file
+  (lambda (port) (display "hello\nworld\n" port)))
+
+(test-equal
+ '("hello" "world")
+ (call-with-input-file (list path: file mmap: #t)
+   (lambda (port) (read-all port read-line))))
+
+;; an empty file
+
+(write-file-u8vector file '#u8())
+
+(test-equal '#u8() (read-all-bytes (list path: file mmap: #t)))
+
+;; the setting is ignored for output-ports
+
+(call-with-output-file (list path: file mmap: #t)
+  (lambda (port) (write-subu8vector bytes 0 10 port)))
+
+(test-equal (subu8vector bytes 0 10) (read-file-u8vector file))
+
+;; the setting is ignored for files which can't be mapped
+
+(if (file-exists? "/dev/null")
+    (test-equal '#u8() (read-all-bytes (list path: "/dev/null" mmap: #t))))
+
+(delete-file file)
+
+(test-error type-exception? (open-input-file (list path: file mmap: 'foo)))
+(test-error type-exception? (open-input-file (list path: file mmap: 1)))
@@ -0,0 +1,42 @@
+(include "#.scm")
+
+(define file "mmap_window_index_temp")
+
+(write-file-u8vector file '#u8(10 20 30 10 20 30 10 20))
+
+(define port (open-input-file (list path: file mmap: #t)))
+
+(define w1 (port-mmap-window port))
+(define w2 (port-mmap-window port 1 6))
+
+(test-equal 0 (mmap-window-index w1 10))
+(test-equal 2 (mmap-window-index w1 30))
+(test-equal #f (mmap-window-index w1 40))
+(test-equal 3 (mmap-window-index w1 10 1))
+(test-equal 6 (mmap-window-index w1 10 4))
+(test-equal #f (mmap-window-index w1 10 4 6))
+(test-equal #f (mmap-window-index w1 10 8))
+(test-equal #f (mmap-window-index w1 10 3 3))
+
+(test-equal 2 (mmap-window-index w2 10)) ;; indices are relative to the window
+(test-equal #f (mmap-window-index w2 20 4))
+
+(close-port port)
+
+(test-equal 1 (mmap-window-index w1 20))
+
+(delete-file file)
+
+(test-error-tail type-exception? (mmap-window-index #f 10))
+(test-error-tail type-exception? (mmap-window-index w1 #f))
+(test-error-tail type-exception? (mmap-window-index w1 10 'foo))
+(test-error-tail type-exception? (mmap-window-index w1 10 0 'foo))
+(test-error-tail type-exception? (mmap-window-index w1 256))
+(test-error-tail type-exception? (mmap-window-index w1 -1))
+(test-error-tail range-exception? (mmap-window-index w1 10 9))
+(test-error-tail range-exception? (mmap-window-index w1 10 5 4))
+(test-error-tail range-exception? (mmap-window-index w2 10 0 6))
+
+(test-error-tail wrong-number-of-arguments-exception? (mmap-window-index))
+(test-error-tail wrong-number-of-arguments-exception? (mmap-window-index w1))
+(test-error-tail wrong-number-of-arguments-exception? (mmap-window-index w1 10 0 8 #f))
@@ -0,0 +1,22 @@
+(include "#.scm")
+
+(define file "mmap_window_length_temp")
+
+(write-file-u8vector file (make-u8vector 100000 7))
+
+(define port (open-input-file (list path: file mmap: #t)))
+
+(test-equal 100000 (mmap-window-length (port-mmap-window port)))
+(test-equal 99000 (mmap-window-length (port-mmap-window port 1000)))
+(test-equal 1 (mmap-window-length (port-mmap-window port 1000 1001)))
+(test-equal 0 (mmap-window-length (port-mmap-window port 100000)))
+
+(close-port port)
+
+(delete-file file)
+
+(test-error-tail type-exception? (mmap-window-length #f))
+(test-error-tail type-exception? (mmap-window-length '#u8(1 2 3)))
+
+(test-error-tail wrong-number-of-arguments-exception? (mmap-window-length))
+(test-error-tail wrong-number-of-arguments-exception? (mmap-window-length #f #f))
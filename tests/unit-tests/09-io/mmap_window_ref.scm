@@ -0,0 +1,34 @@
+(include "#.scm")
+
+(define file "mmap_window_ref_temp")
+
+(write-file-u8vector file '#u8(10 20 30 40 50))
+
+(define port (open-input-file (list path: file mmap: #t)))
+
+(define w1 (port-mmap-window port))
+(define w2 (port-mmap-window port 2 4))
+(define w3 (port-mmap-window port 5))
+
+(test-equal 10 (mmap-window-ref w1 0))
+(test-equal 50 (mmap-window-ref w1 4))
+(test-equal 30 (mmap-window-ref w2 0)) ;; indices are relative to the window
+(test-equal 40 (mmap-window-ref w2 1))
+
+(close-port port)
+
+(test-equal 20 (mmap-window-ref w1 1))
+
+(delete-file file)
+
+(test-error-tail type-exception? (mmap-window-ref #f 0))
+(test-error-tail type-exception? (mmap-window-ref '#u8(1 2 3) 0))
+(test-error-tail type-exception? (mmap-window-ref w1 'foo))
+(test-error-tail range-exception? (mmap-window-ref w1 -1))
+(test-error-tail range-exception? (mmap-window-ref w1 5))
+(test-error-tail range-exception? (mmap-window-ref w2 2))
+(test-error-tail range-exception? (mmap-window-ref w3 0))
+
+(test-error-tail wrong-number-of-arguments-exception? (mmap-window-ref))
+(test-error-tail wrong-number-of-arguments-exception? (mmap-window-ref w1))
+(test-error-tail wrong-number-of-arguments-exception? (mmap-window-ref w1 0 #f))
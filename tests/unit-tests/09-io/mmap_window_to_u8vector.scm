@@ -0,0 +1,45 @@
+(include "#.scm")
+
+(define file "mmap_window_to_u8vector_temp")
+
+(write-file-u8vector file '#u8(10 20 30 40 50))
+
+(define port (open-input-file (list path: file mmap: #t)))
+
+(define w1 (port-mmap-window port))
+(define w2 (port-mmap-window port 1 4))
+
+(test-equal '#u8(10 20 30 40 50) (mmap-window->u8vector w1))
+(test-equal '#u8(30 40 50) (mmap-window->u8vector w1 2))
+(test-equal '#u8(30 40) (mmap-window->u8vector w1 2 4))
+(test-equal '#u8() (mmap-window->u8vector w1 5))
+(test-equal '#u8() (mmap-window->u8vector w1 2 2))
+
+(test-equal '#u8(20 30 40) (mmap-window->u8vector w2))
+(test-equal '#u8(30) (mmap-window->u8vector w2 1 2)) ;; relative to the window
+
+;; the result is a copy
+
+(test-equal
+ '(#u8(99 20 30 40 50) #u8(10 20 30 40 50))
+ (let ((u8vect (mmap-window->u8vector w1)))
+   (u8vector-set! u8vect 0 99)
+   (list u8vect (mmap-window->u8vector w1))))
+
+(close-port port)
+
+(test-equal '#u8(20 30 40) (mmap-window->u8vector w2))
+
+(delete-file file)
+
+(test-error-tail type-exception? (mmap-window->u8vector #f))
+(test-error-tail type-exception? (mmap-window->u8vector '#u8(1 2 3)))
+(test-error-tail type-exception? (mmap-window->u8vector w1 'foo))
+(test-error-tail type-exception? (mmap-window->u8vector w1 0 'foo))
+(test-error-tail range-exception? (mmap-window->u8vector w1 -1))
+(test-error-tail range-exception? (mmap-window->u8vector w1 6))
+(test-error-tail range-exception? (mmap-window->u8vector w1 3 2))
+(test-error-tail range-exception? (mmap-window->u8vector w2 0 4))
+
+(test-error-tail wrong-number-of-arguments-exception? (mmap-window->u8vector))
+(test-error-tail wrong-number-of-arguments-exception? (mmap-window->u8vector w1 0 5 #f))
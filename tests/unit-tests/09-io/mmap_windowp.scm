@@ -0,0 +1,21 @@
+(include "#.scm")
+
+(define file "mmap_windowp_temp")
+
+(write-file-u8vector file '#u8(1 2 3))
+
+(define port (open-input-file (list path: file mmap: #t)))
+
+(test-equal #t (mmap-window? (port-mmap-window port)))
+(test-equal #t (mmap-window? (port-mmap-window port 3)))
+
+(test-equal #f (mmap-window? port))
+(test-equal #f (mmap-window? '#u8(1 2 3)))
+(test-equal #f (mmap-window? #f))
+
+(close-port port)
+
+(delete-file file)
+
+(test-error-tail wrong-number-of-arguments-exception? (mmap-window?))
+(test-error-tail wrong-number-of-arguments-exception? (mmap-window? #f #f))
@@ -0,0 +1,97 @@
+(include "#.scm")
+
+(define file1 "port_copy_temp1")
+(define file2 "port_copy_temp2")
+
+(define bytes (make-test-bytes 200000))
+
+(write-file-u8vector file1 bytes)
+
+;; copy through a u8vector when the ports are not both device ports
+
+(test-equal
+ '(5 #u8(1 2 3 4 5))
+ (let ((out (open-output-u8vector)))
+   (list (port-copy! (open-input-u8vector '#u8(1 2 3 4 5)) out)
+         (get-output-u8vector out))))
+
+(test-equal
+ '(3 #u8(1 2 3) 4)
+ (let ((in (open-input-u8vector '#u8(1 2 3 4 5)))
+       (out (open-output-u8vector)))
+   (list (port-copy! in out 3)
+         (get-output-u8vector out)
+         (read-u8 in))))
+
+(test-equal
+ '(2 #u8(4 5))
+ (let ((in (open-input-u8vector '#u8(1 2 3 4 5)))
+       (out (open-output-u8vector)))
+   (read-u8 in)
+   (read-u8 in)
+   (read-u8 in)
+   (list (port-copy! in out 10)
+         (get-output-u8vector out))))
+
+(test-equal
+ '(0 #u8())
+ (let ((out (open-output-u8vector)))
+   (list (port-copy! (open-input-u8vector '#u8(1 2 3)) out 0)
+         (get-output-u8vector out))))
+
+(test-equal
+ bytes
+ (let ((out (open-output-u8vector)))
+   (call-with-input-file file1 (lambda (in) (port-copy! in out)))
+   (get-output-u8vector out)))
+
+;; copy between files, by the operating system when it allows it
+
+(test-equal
+ (u8vector-length bytes)
+ (call-with-input-file file1
+   (lambda (in)
+     (call-with-output-file file2
+       (lambda (out)
+         (port-copy! in out))))))
+
+(test-equal bytes (read-file-u8vector file2))
+
+;; the bytes already buffered by the ports are copied first
+
+(test-equal
+ (u8vector-length bytes)
+ (call-with-input-file file1
+   (lambda (in)
+     (call-with-output-file file2
+       (lambda (out)
+         (write-u8 (read-u8 in) out)
+         (write-u8 (read-u8 in) out)
+         (+ 2 (port-copy! in out)))))))
+
+(test-equal bytes (read-file-u8vector file2))
+
+(test-equal
+ (subu8vector bytes 1000 101000)
+ (begin
+   (call-with-input-file file1
+     (lambda (in)
+       (call-with-output-file file2
+         (lambda (out)
+           (read-subu8vector (make-u8vector 1000) 0 1000 in)
+           (port-copy! in out 100000)))))
+   (read-file-u8vector file2)))
+
+(delete-file file1)
+(delete-file file2)
+
+(test-error-tail type-exception? (port-copy! #f (open-output-u8vector)))
+(test-error-tail type-exception? (port-copy! (open-input-u8vector '#u8()) #f))
+(test-error-tail type-exception? (port-copy! (open-input-string "") (open-output-u8vector)))
+(test-error-tail type-exception? (port-copy! (open-input-u8vector '#u8()) (open-output-u8vector) 'foo))
+(test-error-tail range-exception? (port-copy! (open-input-u8vector '#u8()) (open-output-u8vector) -1))
+
+(test-error-tail wrong-number-of-arguments-exception? (port-copy!))
+(test-error-tail wrong-number-of-arguments-exception? (port-copy! (open-input-u8vector '#u8())))
+(test-error-tail wrong-number-of-arguments-exception?
+                 (port-copy! (open-input-u8vector '#u8()) (open-output-u8vector) 0 #f))
@@ -0,0 +1,73 @@
+(include "#.scm")
+
+(define file "port_mmap_window_temp")
+
+(write-file-u8vector file '#u8(10 20 30 40 50 60 70 80))
+
+(define port (open-input-file (list path: file mmap: #t)))
+
+(test-equal '#u8(10 20 30 40 50 60 70 80) (mmap-window->u8vector (port-mmap-window port)))
+(test-equal '#u8(30 40 50 60 70 80) (mmap-window->u8vector (port-mmap-window port 2)))
+(test-equal '#u8(30 40 50) (mmap-window->u8vector (port-mmap-window port 2 5)))
+(test-equal '#u8() (mmap-window->u8vector (port-mmap-window port 8)))
+(test-equal '#u8() (mmap-window->u8vector (port-mmap-window port 3 3)))
+
+;; the byte position of the port is not affected
+
+(test-equal 10 (read-u8 port))
+(test-equal '#u8(10 20) (mmap-window->u8vector (port-mmap-window port 0 2)))
+(test-equal 20 (read-u8 port))
+
+;; a window remains valid after the port is closed
+
+(define window (port-mmap-window port 4))
+
+(close-port port)
+
+(test-equal '#u8(50 60 70 80) (mmap-window->u8vector window))
+
+;; but a window can't be created once the port is closed
+
+(test-error os-exception? (port-mmap-window port))
+
+;; the port must have been opened with the mmap: setting
+
+(test-error os-exception?
+            (call-with-input-file file
+              (lambda (port) (port-mmap-window port))))
+
+(if (file-exists? "/dev/null")
+    (test-error os-exception?
+                (call-with-input-file (list path: "/dev/null" mmap: #t)
+                  (lambda (port) (port-mmap-window port)))))
+
+;; a window on an empty file
+
+(write-file-u8vector file '#u8())
+
+(test-equal
+ 0
+ (call-with-input-file (list path: file mmap: #t)
+   (lambda (port) (mmap-window-length (port-mmap-window port)))))
+
+;; argument checking
+
+(write-file-u8vector file '#u8(10 20 30 40 50 60 70 80))
+
+(define port2 (open-input-file (list path: file mmap: #t)))
+
+(test-error-tail type-exception? (port-mmap-window #f))
+(test-error-tail type-exception? (port-mmap-window (open-input-u8vector '#u8(1 2 3))))
+(test-error-tail type-exception? (port-mmap-window port2 'foo))
+(test-error-tail type-exception? (port-mmap-window port2 0 'foo))
+(test-error-tail range-exception? (port-mmap-window port2 -1))
+(test-error-tail range-exception? (port-mmap-window port2 9))
+(test-error-tail range-exception? (port-mmap-window port2 5 4))
+(test-error-tail range-exception? (port-mmap-window port2 0 9))
+
+(test-error-tail wrong-number-of-arguments-exception? (port-mmap-window))
+(test-error-tail wrong-number-of-arguments-exception? (port-mmap-window port2 0 8 #f))
+
+(close-port port2)
+
+(delete-file file)